@@ -240,6 +240,12 @@ case $2 in
         check put
         mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -s 32768 -a 3 -x ${shm_ctx} > $3/put_nbi.log
         check put_nbi
+        mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 8 -s 4096 -a 44 -x ${shm_ctx} > $3/put_nbi_rate.log
+        check put_nbi_rate
+        mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -z 64 -s 240 -a 45 -x ${shm_ctx} > $3/put_nbi_swarm.log
+        check put_nbi_swarm
+        RO_NET_QUEUE_SIZE=9 mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -z 64 -s 240 -a 45 -x ${shm_ctx} > $3/put_nbi_swarm_small_queue.log
+        check put_nbi_swarm_small_queue
         mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -s 8 -a 42 -x ${shm_ctx} > $3/team_ctx_infra.log
         check team_ctx_infra
         mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -s 32768 -a 41 -x ${shm_ctx} > $3/team_ctx_put_nbi.log
@@ -285,6 +291,15 @@ case $2 in
     *"put")
         mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -s 32768 -a 2 -x ${shm_ctx}
         ;;
+    *"put_nbi_swarm")
+        mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -z 64 -s 240 -a 45 -x ${shm_ctx}
+        ;;
+    *"put_nbi_swarm_small_queue")
+        RO_NET_QUEUE_SIZE=9 mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -z 64 -s 240 -a 45 -x ${shm_ctx}
+        ;;
+    *"put_nbi_rate")
+        mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 8 -s 4096 -a 44 -x ${shm_ctx}
+        ;;
     *"put_nbi")
         mpirun -np 2 ${gdb_cmd} $1 -t 1 -w 1 -s 32768 -a 3 -x ${shm_ctx}
         ;;
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "put_nbi_rate_tester.hpp"
+
+#include <roc_shmem.hpp>
+
+using namespace rocshmem;
+
+/**
+ * Number of non-blocking puts issued between two quiets.
+ */
+constexpr int PUT_NBI_RATE_WINDOW = 64;
+
+/******************************************************************************
+ * DEVICE TEST KERNEL
+ *****************************************************************************/
+__global__ void
+PutNBIRateTest(int loop,
+               int skip,
+               uint64_t *timer,
+               char *s_buf,
+               char *r_buf,
+               int size,
+               ShmemContextType ctx_type)
+{
+    __shared__ roc_shmem_ctx_t ctx;
+    roc_shmem_wg_init();
+    roc_shmem_wg_ctx_create(ctx_type, &ctx);
+
+    if (hipThreadIdx_x == 0) {
+        uint64_t start;
+        char *dst = r_buf + hipBlockIdx_x * size;
+        char *src = s_buf + hipBlockIdx_x * size;
+
+        for (int i = 0; i < loop + skip; i++) {
+            if (i == skip)
+                start = roc_shmem_timer();
+
+            for (int j = 0; j < PUT_NBI_RATE_WINDOW; j++) {
+                roc_shmem_ctx_putmem_nbi(ctx, dst, src, size, 1);
+            }
+            roc_shmem_ctx_quiet(ctx);
+        }
+
+        timer[hipBlockIdx_x] =  roc_shmem_timer() - start;
+    }
+
+    __syncthreads();
+
+    roc_shmem_wg_ctx_destroy(ctx);
+    roc_shmem_wg_finalize();
+}
+
+/******************************************************************************
+ * HOST TESTER CLASS METHODS
+ *****************************************************************************/
+PutNBIRateTester::PutNBIRateTester(TesterArguments args)
+    : Tester(args)
+{
+    s_buf = (char *)roc_shmem_malloc(args.max_msg_size * args.num_wgs);
+    r_buf = (char *)roc_shmem_malloc(args.max_msg_size * args.num_wgs);
+}
+
+PutNBIRateTester::~PutNBIRateTester()
+{
+    roc_shmem_free(s_buf);
+    roc_shmem_free(r_buf);
+}
+
+void
+PutNBIRateTester::resetBuffers(uint64_t size)
+{
+    memset(s_buf, '0', args.max_msg_size * args.num_wgs);
+    memset(r_buf, '1', args.max_msg_size * args.num_wgs);
+}
+
+void
+PutNBIRateTester::launchKernel(dim3 gridSize,
+                               dim3 blockSize,
+                               int loop,
+                               uint64_t size)
+{
+    size_t shared_bytes;
+    roc_shmem_dynamic_shared(&shared_bytes);
+
+    hipLaunchKernelGGL(PutNBIRateTest,
+                       gridSize,
+                       blockSize,
+                       shared_bytes,
+                       stream,
+                       loop,
+                       args.skip,
+                       timer,
+                       s_buf,
+                       r_buf,
+                       size,
+                       _shmem_context);
+
+    /**
+     * The work-groups run concurrently, so dividing the timed messages of
+     * all work-groups by the average work-group time gives the aggregate
+     * message rate of the PE.
+     */
+    num_msgs = (loop + args.skip) * PUT_NBI_RATE_WINDOW * gridSize.x;
+    num_timed_msgs = loop * PUT_NBI_RATE_WINDOW * gridSize.x;
+}
+
+void
+PutNBIRateTester::verifyResults(uint64_t size)
+{
+    if (args.myid == 1) {
+        for (uint64_t i = 0; i < size * args.num_wgs; i++) {
+            if (r_buf[i] != '0') {
+                fprintf(stderr, "Data validation error at idx %lu\n", i);
+                fprintf(stderr, "Got %c, Expected %c\n", r_buf[i], '0');
+                exit(-1);
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef _PUT_NBI_RATE_TESTER_HPP_
+#define _PUT_NBI_RATE_TESTER_HPP_
+
+#include "tester.hpp"
+
+/******************************************************************************
+ * HOST TESTER CLASS
+ *****************************************************************************/
+/**
+ * Measures the aggregate message rate of roc_shmem_ctx_putmem_nbi across
+ * message sizes. Every work-group issues windows of non-blocking puts to
+ * its own slice of the remote buffer followed by a quiet.
+ */
+class PutNBIRateTester : public Tester
+{
+  public:
+    explicit PutNBIRateTester(TesterArguments args);
+    virtual ~PutNBIRateTester();
+
+  protected:
+    virtual void
+    resetBuffers(uint64_t size) override;
+
+    virtual void
+    launchKernel(dim3 gridSize,
+                 dim3 blockSize,
+                 int loop,
+                 uint64_t size) override;
+
+    virtual void
+    verifyResults(uint64_t size) override;
+
+    char *s_buf = nullptr;
+    char *r_buf = nullptr;
+};
+
+#endif
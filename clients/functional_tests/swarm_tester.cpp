@@ -69,6 +69,53 @@ GetSwarmTest(int loop,
     roc_shmem_wg_finalize();
 }
 
+/*
+ * Every thread of the work-group issues one non-blocking put at once, so
+ * a whole wavefront reserves queue slots together. With inline puts at
+ * their largest size the wavefront needs more slots than the queue has.
+ */
+__global__ void
+PutNBISwarmTest(int loop,
+                int skip,
+                uint64_t *timer,
+                char *s_buf,
+                char *r_buf,
+                int size,
+                ShmemContextType ctx_type)
+{
+    __shared__ roc_shmem_ctx_t ctx;
+
+    int provided;
+    roc_shmem_wg_init_thread(ROC_SHMEM_THREAD_MULTIPLE, &provided);
+    assert(provided == ROC_SHMEM_THREAD_MULTIPLE);
+
+    roc_shmem_wg_ctx_create(ctx_type, &ctx);
+
+    __syncthreads();
+
+    int index = hipThreadIdx_x * size;
+    uint64_t start = 0;
+
+    for (int i = 0; i < loop + skip; i++) {
+
+        if (i == skip)
+            start = roc_shmem_timer();
+
+        roc_shmem_ctx_putmem_nbi(ctx, &r_buf[index], &s_buf[index], size, 1);
+
+        __syncthreads();
+
+    }
+
+    roc_shmem_ctx_quiet(ctx);
+
+    atomicAdd((unsigned long long *) &timer[hipBlockIdx_x],
+                roc_shmem_timer() - start);
+
+    roc_shmem_wg_ctx_destroy(ctx);
+    roc_shmem_wg_finalize();
+}
+
 /******************************************************************************
  * HOST TESTER CLASS METHODS
  *****************************************************************************/
@@ -121,3 +168,52 @@ GetSwarmTester::verifyResults(uint64_t size)
         }
     }
 }
+
+PutNBISwarmTester::PutNBISwarmTester(TesterArguments args)
+        : PrimitiveTester(args)
+{
+}
+
+PutNBISwarmTester::~PutNBISwarmTester()
+{
+}
+
+void
+PutNBISwarmTester::launchKernel(dim3 gridSize,
+                                dim3 blockSize,
+                                int loop,
+                                uint64_t size)
+{
+    size_t shared_bytes;
+    roc_shmem_dynamic_shared(&shared_bytes);
+
+    hipLaunchKernelGGL(PutNBISwarmTest,
+                       gridSize,
+                       blockSize,
+                       shared_bytes,
+                       stream,
+                       loop,
+                       args.skip,
+                       timer,
+                       s_buf,
+                       r_buf,
+                       size,
+                       _shmem_context);
+
+    num_msgs = (loop + args.skip) * gridSize.x * blockSize.x;
+    num_timed_msgs = loop * gridSize.x * blockSize.x;
+}
+
+void
+PutNBISwarmTester::verifyResults(uint64_t size)
+{
+    if (args.myid == 1) {
+        for (int i = 0; i < size * args.wg_size; i++) {
+            if (r_buf[i] != '0') {
+                fprintf(stderr, "Data validation error at idx %d\n", i);
+                fprintf(stderr, "Got %c, Expected %c\n", r_buf[i], '0');
+                exit(-1);
+            }
+        }
+    }
+}
@@ -36,6 +36,15 @@ GetSwarmTest(int loop,
              char *r_buf,
              int size);
 
+__global__ void
+PutNBISwarmTest(int loop,
+                int skip,
+                uint64_t *timer,
+                char *s_buf,
+                char *r_buf,
+                int size,
+                ShmemContextType ctx_type);
+
 /******************************************************************************
  * HOST TESTER CLASS
  *****************************************************************************/
@@ -56,4 +65,21 @@ class GetSwarmTester : public PrimitiveTester
     verifyResults(uint64_t size) override;
 };
 
+class PutNBISwarmTester : public PrimitiveTester
+{
+  public:
+    explicit PutNBISwarmTester(TesterArguments args);
+    virtual ~PutNBISwarmTester();
+
+  protected:
+    virtual void
+    launchKernel(dim3 gridSize,
+                 dim3 blockSize,
+                 int loop,
+                 uint64_t size) override;
+
+    virtual void
+    verifyResults(uint64_t size) override;
+};
+
 #endif
@@ -35,6 +35,7 @@
 #include "team_broadcast_tester.hpp"
 #include "primitive_tester.hpp"
 #include "primitive_mr_tester.hpp"
+#include "put_nbi_rate_tester.hpp"
 #include "team_ctx_primitive_tester.hpp"
 #include "team_ctx_infra_tester.hpp"
 #include "primitive_amo_tester.hpp"
@@ -488,6 +489,17 @@ Tester::create(TesterArguments args)
                 std::cout << "Non-Blocking Put message rate***" << std::endl;
             testers.push_back(new PrimitiveMRTester(args));
             return testers;
+        case PutNBIRateTestType:
+            if (rank == 0)
+                std::cout << "Non-Blocking Put aggregate message rate***"
+                          << std::endl;
+            testers.push_back(new PutNBIRateTester(args));
+            return testers;
+        case PutNBISwarmTestType:
+            if (rank == 0)
+                std::cout << "Non-Blocking Put Swarm***" << std::endl;
+            testers.push_back(new PutNBISwarmTester(args));
+            return testers;
         default:
             if (rank == 0)
                 std::cout << "Unknown***" << std::endl;
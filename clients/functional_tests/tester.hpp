@@ -77,7 +77,9 @@ enum TestType
     TeamCtxPutTestType      = 40,
     TeamCtxPutNBITestType   = 41,
     TeamCtxInfraTestType    = 42,
-    PutNBIMRTestType        = 43
+    PutNBIMRTestType        = 43,
+    PutNBIRateTestType      = 44,
+    PutNBISwarmTestType     = 45
 };
 
 enum OpType
@@ -94,6 +94,7 @@ TesterArguments::TesterArguments(int argc, char *argv[])
         max_msg_size = min_msg_size;
         break;
       case PutNBIMRTestType:
+      case PutNBISwarmTestType:
         min_msg_size = max_msg_size;
 	break;
       default:
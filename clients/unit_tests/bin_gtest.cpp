@@ -31,7 +31,7 @@ TEST_F(BinTestFixture, is_empty_check)
 
 TEST_F(BinTestFixture, is_not_empty_check)
 {
-    bin_.put(nullptr);
+    bin_.put(&table_, 0);
 
     ASSERT_FALSE(bin_.empty());
 }
@@ -39,20 +39,38 @@ TEST_F(BinTestFixture, is_not_empty_check)
 TEST_F(BinTestFixture, size_check)
 {
     ASSERT_EQ(bin_.size(), 0);
-    bin_.put(nullptr);
+    bin_.put(&table_, 0);
     ASSERT_EQ(bin_.size(), 1);
-    bin_.put(nullptr);
+    bin_.put(&table_, 1);
     ASSERT_EQ(bin_.size(), 2);
 }
 
 TEST_F(BinTestFixture, retrieval_check)
 {
-    char* p_xa {reinterpret_cast<char*>(0xa)};
-    char* p_xb {reinterpret_cast<char*>(0xb)};
-    bin_.put(p_xa);
-    bin_.put(p_xb);
-    auto g_xb = bin_.get();
-    auto g_xa = bin_.get();
-    ASSERT_EQ(p_xa, g_xa);
-    ASSERT_EQ(p_xb, g_xb);
+    uint32_t s_a {0xa};
+    uint32_t s_b {0xb};
+    bin_.put(&table_, s_a);
+    bin_.put(&table_, s_b);
+    auto g_b = bin_.get(&table_);
+    auto g_a = bin_.get(&table_);
+    ASSERT_EQ(s_a, g_a);
+    ASSERT_EQ(s_b, g_b);
+    ASSERT_TRUE(bin_.empty());
+}
+
+TEST_F(BinTestFixture, remove_check)
+{
+    uint32_t s_a {0xa};
+    uint32_t s_b {0xb};
+    uint32_t s_c {0xc};
+    bin_.put(&table_, s_a);
+    bin_.put(&table_, s_b);
+    bin_.put(&table_, s_c);
+    bin_.remove(&table_, s_b);
+    ASSERT_EQ(bin_.size(), 2);
+    bin_.remove(&table_, s_c);
+    ASSERT_EQ(bin_.size(), 1);
+    auto g_a = bin_.get(&table_);
+    ASSERT_EQ(s_a, g_a);
+    ASSERT_TRUE(bin_.empty());
 }
@@ -26,6 +26,7 @@
 #include "gtest/gtest.h"
 
 #include "memory/bin.hpp"
+#include "memory/block_table.hpp"
 
 namespace rocshmem {
 
@@ -33,9 +34,14 @@ class BinTestFixture : public ::testing::Test
 {
   protected:
     /**
-     * @brief A bin object containing pointers
+     * @brief A block table holding the bin's links
      */
-    Bin<char*> bin_ {};
+    BlockTable table_ {16};
+
+    /**
+     * @brief A bin object containing slot indices
+     */
+    Bin bin_ {};
 };
 
 } // namespace rocshmem
@@ -150,6 +150,6 @@ TEST_F(BinnerTestFixture, bin_get_one_gig)
 
     ASSERT_EQ(bin.size(), 1);
 
-    auto address_record = bin.get();
+    auto address_record = bins->get(gibibyte);
     ASSERT_EQ(address_record.get_size(), gibibyte);
 }
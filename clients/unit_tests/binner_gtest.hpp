@@ -25,13 +25,11 @@
 
 #include "gtest/gtest.h"
 
-#include <map>
-
 #include "memory/address_record.hpp"
-#include "memory/bin.hpp"
 #include "memory/binner.hpp"
 #include "memory/heap_memory.hpp"
 #include "memory/hip_allocator.hpp"
+#include "memory/pow2_bin_array.hpp"
 
 namespace rocshmem {
 
@@ -43,9 +41,9 @@ class BinnerTestFixture : public ::testing::Test
     using AR_T = AddressRecord;
 
     /**
-     * @brief Helper type for size to bin maps
+     * @brief Helper type for size-indexed bins
      */
-    using BINS_T = std::map<size_t, Bin<AR_T>>;
+    using BINS_T = Pow2BinArray<AR_T>;
 
     /**
      * @brief Helper type for binner
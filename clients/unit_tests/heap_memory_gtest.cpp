@@ -40,3 +40,62 @@ TEST_F(HeapMemoryTestFixture, ptr_check)
 {
     ASSERT_NE(heap_mem_.get_ptr(), nullptr);
 }
+
+TEST(HeapMemoryTest, lazy_unsupported_allocates_full_heap)
+{
+    setenv("ROC_SHMEM_HEAP_LAZY", "1", 1);
+    HeapMemory<HIPAllocator> heap_mem {2048};
+    unsetenv("ROC_SHMEM_HEAP_LAZY");
+
+    ASSERT_FALSE(heap_mem.is_lazy());
+    ASSERT_NE(heap_mem.get_ptr(), nullptr);
+    ASSERT_EQ(heap_mem.get_committed(), 2048);
+}
+
+TEST(HeapMemoryTest, lazy_commits_touched_chunks)
+{
+    size_t chunk {size_t{1} << 21};
+    setenv("ROC_SHMEM_HEAP_LAZY", "1", 1);
+    HeapMemory<HostMmapAllocator> heap_mem {size_t{1} << 30};
+    unsetenv("ROC_SHMEM_HEAP_LAZY");
+
+    ASSERT_TRUE(heap_mem.is_lazy());
+    ASSERT_EQ(heap_mem.get_committed(), 0);
+
+    auto ptr {heap_mem.get_ptr() + 5 * chunk + 100};
+    heap_mem.commit(ptr, chunk);
+    ASSERT_EQ(heap_mem.get_committed(), 2 * chunk);
+    memset(ptr, 1, chunk);
+
+    heap_mem.commit(ptr, 8);
+    ASSERT_EQ(heap_mem.get_committed(), 2 * chunk);
+}
+
+TEST(HeapMemoryTest, lazy_chunk_size)
+{
+    size_t chunk {size_t{1} << 16};
+    setenv("ROC_SHMEM_HEAP_LAZY", "1", 1);
+    setenv("ROC_SHMEM_HEAP_CHUNK_SIZE", "65536", 1);
+    HeapMemory<HostMmapAllocator> heap_mem {size_t{1} << 20};
+    unsetenv("ROC_SHMEM_HEAP_LAZY");
+    unsetenv("ROC_SHMEM_HEAP_CHUNK_SIZE");
+
+    heap_mem.commit(heap_mem.get_ptr() + chunk - 1, 2);
+    ASSERT_EQ(heap_mem.get_committed(), 2 * chunk);
+    heap_mem.get_ptr()[chunk] = 1;
+}
+
+TEST(HeapMemoryTest, lazy_commit_failure_reported)
+{
+    setenv("ROC_SHMEM_HEAP_LAZY", "1", 1);
+    setenv("ROC_SHMEM_HOST_HEAP_PAGES", "2M", 1);
+    HeapMemory<HostMmapAllocator> heap_mem {size_t{1} << 30};
+    unsetenv("ROC_SHMEM_HEAP_LAZY");
+    unsetenv("ROC_SHMEM_HOST_HEAP_PAGES");
+
+    ASSERT_TRUE(heap_mem.is_lazy());
+    if (heap_mem.commit(heap_mem.get_ptr(), size_t{1} << 30)) {
+        GTEST_SKIP() << "huge pages available; commit cannot fail";
+    }
+    ASSERT_LT(heap_mem.get_committed(), size_t{1} << 30);
+}
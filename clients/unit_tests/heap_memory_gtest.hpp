@@ -25,10 +25,14 @@
 
 #include "gtest/gtest.h"
 
+#include <cstdlib>
+#include <cstring>
+
 #include <hip/hip_runtime_api.h>
 
 #include "memory/hip_allocator.hpp"
 #include "memory/heap_memory.hpp"
+#include "memory/mmap_allocator.hpp"
 
 namespace rocshmem {
 
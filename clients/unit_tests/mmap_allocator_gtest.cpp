@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "mmap_allocator_gtest.hpp"
+
+using namespace rocshmem;
+
+TEST_F(MmapAllocatorTestFixture, default_policy)
+{
+    HostMmapAllocator allocator {};
+    ASSERT_EQ(allocator.page_mode(), PageMode::DEFAULT);
+    ASSERT_EQ(allocator.numa_node(), HostMmapAllocator::NO_NUMA_NODE);
+    ASSERT_FALSE(allocator.is_managed());
+}
+
+TEST_F(MmapAllocatorTestFixture, policy_from_environment)
+{
+    setenv("ROC_SHMEM_HOST_HEAP_PAGES", "thp", 1);
+    setenv("ROC_SHMEM_HOST_HEAP_NUMA_NODE", "0", 1);
+    HostMmapAllocator thp {};
+    ASSERT_EQ(thp.page_mode(), PageMode::TRANSPARENT_HUGE);
+    ASSERT_EQ(thp.numa_node(), 0);
+
+    setenv("ROC_SHMEM_HOST_HEAP_PAGES", "2M", 1);
+    ASSERT_EQ(HostMmapAllocator{}.page_mode(), PageMode::HUGETLB_2M);
+
+    setenv("ROC_SHMEM_HOST_HEAP_PAGES", "1G", 1);
+    ASSERT_EQ(HostMmapAllocator{}.page_mode(), PageMode::HUGETLB_1G);
+
+    setenv("ROC_SHMEM_HOST_HEAP_PAGES", "bogus", 1);
+    ASSERT_EQ(HostMmapAllocator{}.page_mode(), PageMode::DEFAULT);
+}
+
+TEST_F(MmapAllocatorTestFixture, allocate_0)
+{
+    HostMmapAllocator allocator {};
+    void* ptr {reinterpret_cast<void*>(0x1)};
+    allocator.allocate(&ptr, 0);
+    ASSERT_EQ(ptr, nullptr);
+    allocator.deallocate(ptr);
+}
+
+TEST_F(MmapAllocatorTestFixture, default_pages)
+{
+    HostMmapAllocator allocator {};
+    auto address {touch(&allocator, 12345)};
+    ASSERT_EQ(address % HostMmapAllocator::page_size(PageMode::DEFAULT), 0);
+}
+
+TEST_F(MmapAllocatorTestFixture, transparent_huge_pages_aligned)
+{
+    HostMmapAllocator allocator {PageMode::TRANSPARENT_HUGE,
+                                 HostMmapAllocator::NO_NUMA_NODE};
+    auto address {touch(&allocator, 3 * two_mebibytes_ + 1)};
+    ASSERT_EQ(address % two_mebibytes_, 0);
+}
+
+TEST_F(MmapAllocatorTestFixture, hugetlb_or_fallback)
+{
+    HostMmapAllocator allocator {PageMode::HUGETLB_2M,
+                                 HostMmapAllocator::NO_NUMA_NODE};
+    auto address {touch(&allocator, two_mebibytes_)};
+    ASSERT_EQ(address % two_mebibytes_, 0);
+    ASSERT_TRUE(allocator.page_mode() == PageMode::HUGETLB_2M ||
+                allocator.page_mode() == PageMode::TRANSPARENT_HUGE);
+}
+
+TEST_F(MmapAllocatorTestFixture, numa_node_0)
+{
+    HostMmapAllocator allocator {PageMode::DEFAULT, 0};
+    touch(&allocator, 1 << 20);
+}
+
+TEST_F(MmapAllocatorTestFixture, heap_memory_frees_with_other_instance)
+{
+    HeapMemory<HostMmapAllocator> heap_mem {size_t{1} << 30};
+    ASSERT_NE(heap_mem.get_ptr(), nullptr);
+    ASSERT_EQ(heap_mem.get_size(), size_t{1} << 30);
+    ASSERT_FALSE(heap_mem.is_managed());
+    heap_mem.get_ptr()[0] = 1;
+}
+
+TEST_F(MmapAllocatorTestFixture, commit_backs_reservation)
+{
+    HostMmapAllocator allocator {};
+    void* ptr {nullptr};
+    allocator.reserve(&ptr, 1 << 20);
+    ASSERT_NE(ptr, nullptr);
+
+    ASSERT_TRUE(allocator.commit(ptr, allocator.commit_granularity()));
+    memset(ptr, 1, allocator.commit_granularity());
+    allocator.deallocate(ptr);
+}
+
+TEST_F(MmapAllocatorTestFixture, commit_unmapped_fails)
+{
+    HostMmapAllocator allocator {};
+    void* ptr {nullptr};
+    allocator.reserve(&ptr, 1 << 20);
+    ASSERT_NE(ptr, nullptr);
+    allocator.deallocate(ptr);
+
+    ASSERT_FALSE(allocator.commit(ptr, allocator.commit_granularity()));
+}
+
+TEST_F(MmapAllocatorTestFixture, hugetlb_commit_without_free_pages_fails)
+{
+    HostMmapAllocator allocator {PageMode::HUGETLB_2M,
+                                 HostMmapAllocator::NO_NUMA_NODE};
+    void* ptr {nullptr};
+    allocator.reserve(&ptr, 2 * two_mebibytes_);
+    ASSERT_NE(ptr, nullptr);
+    if (allocator.page_mode() != PageMode::HUGETLB_2M ||
+        free_huge_pages_2m() >= 2) {
+        allocator.deallocate(ptr);
+        GTEST_SKIP() << "needs 2M hugetlbfs support without free pages";
+    }
+
+    /*
+     * The reservation is MAP_NORESERVE, so touching it would raise
+     * SIGBUS; commit must report the failure instead.
+     */
+    ASSERT_FALSE(allocator.commit(ptr, 2 * two_mebibytes_));
+    allocator.deallocate(ptr);
+}
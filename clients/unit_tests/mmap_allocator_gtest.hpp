@@ -0,0 +1,109 @@
+/******************************************************************************
+ * Copyright (c) 2021 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_MMAP_ALLOCATOR_GTEST_HPP
+#define ROCSHMEM_MMAP_ALLOCATOR_GTEST_HPP
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "memory/heap_memory.hpp"
+#include "memory/mmap_allocator.hpp"
+
+namespace rocshmem {
+
+class MmapAllocatorTestFixture : public ::testing::Test
+{
+  protected:
+    /**
+     * @brief Helper type for page modes
+     */
+    using PageMode = HostMmapAllocator::PageMode;
+
+    /**
+     * @brief Clear the policy environment variables
+     */
+    void
+    SetUp() override {
+        unsetenv("ROC_SHMEM_HOST_HEAP_PAGES");
+        unsetenv("ROC_SHMEM_HOST_HEAP_NUMA_NODE");
+    }
+
+    /**
+     * @brief Clear the policy environment variables
+     */
+    void
+    TearDown() override {
+        SetUp();
+    }
+
+    /**
+     * @brief Allocate, touch and free a buffer
+     *
+     * @param[in] Allocator to use
+     * @param[in] Size in bytes of the buffer
+     *
+     * @return Address of the buffer (no longer valid)
+     */
+    uintptr_t
+    touch(HostMmapAllocator* allocator, size_t size) {
+        void* ptr {nullptr};
+        allocator->allocate(&ptr, size);
+        EXPECT_NE(ptr, nullptr);
+        if (!ptr) {
+            return 0;
+        }
+        memset(ptr, 0xA5, size);
+        auto c_ptr {reinterpret_cast<unsigned char*>(ptr)};
+        EXPECT_EQ(c_ptr[0], 0xA5);
+        EXPECT_EQ(c_ptr[size - 1], 0xA5);
+        allocator->deallocate(ptr);
+        return reinterpret_cast<uintptr_t>(ptr);
+    }
+
+    /**
+     * @brief Number of free 2M hugetlbfs pages in the pool
+     *
+     * @return Page count or 0 if the pool is not exposed
+     */
+    size_t
+    free_huge_pages_2m() {
+        std::ifstream pool {
+            "/sys/kernel/mm/hugepages/hugepages-2048kB/free_hugepages"};
+        size_t count {0};
+        pool >> count;
+        return count;
+    }
+
+    /**
+     * @brief Named constant for two mebibytes
+     */
+    static constexpr size_t two_mebibytes_ {size_t{1} << 21};
+};
+
+} // namespace rocshmem
+
+#endif // ROCSHMEM_MMAP_ALLOCATOR_GTEST_HPP
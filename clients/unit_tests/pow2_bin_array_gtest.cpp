@@ -0,0 +1,148 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#include "pow2_bin_array_gtest.hpp"
+
+using namespace rocshmem;
+
+TEST_F(Pow2BinArrayTestFixture, enabled_bins)
+{
+    ASSERT_EQ(bins_.size(), 24);
+    ASSERT_EQ(bins_.smallest_bin_size(), min_bin_size_);
+    ASSERT_EQ(bins_.largest_bin_size(), max_bin_size_);
+    ASSERT_EQ(bins_.count(64), 0);
+    ASSERT_EQ(bins_.count(4096), 1);
+    ASSERT_EQ(bins_.count(max_bin_size_ << 1), 0);
+}
+
+TEST_F(Pow2BinArrayTestFixture, round_up)
+{
+    ASSERT_EQ(bins_.round_up(1), 128);
+    ASSERT_EQ(bins_.round_up(128), 128);
+    ASSERT_EQ(bins_.round_up(129), 256);
+    ASSERT_EQ(bins_.round_up(4096), 4096);
+    ASSERT_EQ(bins_.round_up(max_bin_size_), max_bin_size_);
+    ASSERT_EQ(bins_.round_up(max_bin_size_ + 1), 0);
+}
+
+TEST_F(Pow2BinArrayTestFixture, put_get_updates_occupancy)
+{
+    ASSERT_TRUE(bins_.empty(4096));
+    ASSERT_EQ(bins_.find_nonempty(128), 0);
+
+    put_in_both(4096);
+    ASSERT_FALSE(bins_.empty(4096));
+    ASSERT_EQ(bins_[4096].size(), 1);
+    ASSERT_EQ(bins_.find_nonempty(128), 4096);
+    ASSERT_EQ(bins_.find_nonempty(4096), 4096);
+    ASSERT_EQ(bins_.find_nonempty(8192), 0);
+
+    auto record {bins_.get(4096)};
+    ASSERT_EQ(record.get_size(), 4096);
+    ASSERT_TRUE(bins_.empty(4096));
+    ASSERT_EQ(bins_.find_nonempty(128), 0);
+}
+
+TEST_F(Pow2BinArrayTestFixture, remove_updates_occupancy)
+{
+    put_in_both(256);
+    AddressRecord missing {heap_base_ + 512, 256};
+    ASSERT_FALSE(bins_.remove(256, missing));
+    ASSERT_FALSE(bins_.empty(256));
+
+    AddressRecord wrong_size {heap_base_ + 256, 128};
+    ASSERT_FALSE(bins_.remove(128, wrong_size));
+    ASSERT_FALSE(bins_.empty(256));
+
+    AddressRecord present {heap_base_ + 256, 256};
+    ASSERT_TRUE(bins_.remove(256, present));
+    ASSERT_TRUE(bins_.empty(256));
+}
+
+TEST_F(Pow2BinArrayTestFixture, remove_past_heap_end)
+{
+    AddressRecord past_end {heap_base_ + max_bin_size_, max_bin_size_};
+    ASSERT_FALSE(bins_.remove(max_bin_size_, past_end));
+}
+
+TEST_F(Pow2BinArrayTestFixture, proffered_records_keep_size)
+{
+    put_in_both(4096);
+    auto record {bins_.get(4096)};
+    bins_.mark_proffered(record);
+
+    auto proffered {bins_.retrieve_proffered(record.get_address())};
+    ASSERT_EQ(proffered.get_address(), record.get_address());
+    ASSERT_EQ(proffered.get_size(), 4096);
+}
+
+TEST_F(Pow2BinArrayTestFixture, benchmark_find_nonempty_vs_map)
+{
+    /*
+     * Leave only a few large bins populated so both layouts must search
+     * past many empty bins for most requests (the common case right
+     * after initialization or after buddies coalesce).
+     */
+    put_in_both(max_bin_size_);
+    put_in_both(max_bin_size_ >> 4);
+    put_in_both(1 << 20);
+
+    constexpr size_t num_requests {1 << 12};
+    std::vector<size_t> requests(num_requests);
+    std::mt19937_64 gen {42};
+    std::uniform_int_distribution<unsigned> shift {0, 30};
+    for (auto& request : requests) {
+        request = (size_t{1} << shift(gen)) + (gen() & 0x7f);
+        request = std::min(request, max_bin_size_);
+    }
+
+    constexpr int iterations {256};
+    size_t map_checksum {0};
+    size_t array_checksum {0};
+
+    auto map_start {std::chrono::steady_clock::now()};
+    for (int i {0}; i < iterations; i++) {
+        for (auto request : requests) {
+            map_checksum += map_find_nonempty(request);
+        }
+    }
+    auto map_end {std::chrono::steady_clock::now()};
+
+    auto array_start {std::chrono::steady_clock::now()};
+    for (int i {0}; i < iterations; i++) {
+        for (auto request : requests) {
+            array_checksum += bins_.find_nonempty(bins_.round_up(request));
+        }
+    }
+    auto array_end {std::chrono::steady_clock::now()};
+
+    ASSERT_EQ(map_checksum, array_checksum);
+
+    auto num_lookups {static_cast<double>(iterations * num_requests)};
+    std::chrono::duration<double, std::nano> map_ns {map_end - map_start};
+    std::chrono::duration<double, std::nano> array_ns {array_end - array_start};
+    std::cout << "[ BENCH    ] std::map lookup      "
+              << map_ns.count() / num_lookups << " ns/op" << std::endl;
+    std::cout << "[ BENCH    ] Pow2BinArray lookup  "
+              << array_ns.count() / num_lookups << " ns/op" << std::endl;
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_POW2_BIN_ARRAY_GTEST_HPP
+#define ROCSHMEM_POW2_BIN_ARRAY_GTEST_HPP
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "memory/address_record.hpp"
+#include "memory/pow2_bin_array.hpp"
+
+namespace rocshmem {
+
+class Pow2BinArrayTestFixture : public ::testing::Test
+{
+  protected:
+    /**
+     * @brief Helper type for address records
+     */
+    using AR_T = AddressRecord;
+
+    /**
+     * @brief Helper type for the previous size to bin map layout
+     */
+    using MAP_BINS_T = std::map<size_t, std::vector<AR_T>>;
+
+    /**
+     * @brief Enable bins from 128 bytes to 1 gibibyte in both layouts
+     *
+     * The heap is never dereferenced so a fake base address is used.
+     */
+    void
+    SetUp() override {
+        for (size_t size {min_bin_size_}; size <= max_bin_size_; size <<= 1) {
+            bins_.insert(size);
+            map_bins_.insert({size, {}});
+        }
+        bins_.attach_heap(heap_base_, max_bin_size_);
+    }
+
+    /**
+     * @brief Store the same record in both layouts
+     *
+     * Records of different sizes are placed at non-overlapping offsets.
+     *
+     * @param[in] A power-of-two bin size
+     */
+    void
+    put_in_both(size_t bin_size) {
+        AR_T record {heap_base_ + bin_size % max_bin_size_, bin_size};
+        bins_.put(bin_size, record);
+        map_bins_[bin_size].push_back(record);
+    }
+
+    /**
+     * @brief First non-empty bin at or above a request using the map
+     *
+     * Mirrors the lower_bound search and upward walk done by the map
+     * layout.
+     *
+     * @param[in] Size in bytes of a request
+     *
+     * @return A bin size or 0 if all candidate bins are empty
+     */
+    size_t
+    map_find_nonempty(size_t request_size) {
+        auto it {map_bins_.lower_bound(request_size)};
+        while (it != map_bins_.end()) {
+            auto& [bin_size, bin] {*it};
+            if (!bin.empty()) {
+                return bin_size;
+            }
+            it++;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Fake heap base address used by the fixture
+     */
+    char* heap_base_ {reinterpret_cast<char*>(size_t{1} << 40)};
+
+    /**
+     * @brief Smallest bin size used by the fixture
+     */
+    static constexpr size_t min_bin_size_ {128};
+
+    /**
+     * @brief Largest bin size used by the fixture
+     */
+    static constexpr size_t max_bin_size_ {size_t{1} << 30};
+
+    /**
+     * @brief Flat bin layout under test
+     */
+    Pow2BinArray<AR_T> bins_ {};
+
+    /**
+     * @brief Map bin layout used as a baseline
+     */
+    MAP_BINS_T map_bins_ {};
+};
+
+} // namespace rocshmem
+
+#endif // ROCSHMEM_POW2_BIN_ARRAY_GTEST_HPP
@@ -146,9 +146,14 @@ TEST_F(Pow2BinsTestFixture, alloc_256_bytes_X2_free_256_bytes_X2)
     ASSERT_EQ(bin.size(), 0);
 
     strat_.free(c_ptr_1);
+    ASSERT_EQ(bin.size(), 1);
+
     strat_.free(c_ptr_2);
+    ASSERT_EQ(bin.size(), 0);
 
-    ASSERT_EQ(bin.size(), 2);
+    size_t gibibyte {1 << 30};
+    auto &top_bin {(*bins)[gibibyte]};
+    ASSERT_EQ(top_bin.size(), 1);
 }
 
 TEST_F(Pow2BinsTestFixture, alloc_1GB_free_1GB)
@@ -166,3 +171,157 @@ TEST_F(Pow2BinsTestFixture, alloc_1GB_free_1GB)
 
     ASSERT_EQ(bin.size(), 1);
 }
+
+TEST_F(Pow2BinsTestFixture, free_buddy_coalesces_into_larger_bin)
+{
+    char* c_ptr_1 {nullptr};
+    char* c_ptr_2 {nullptr};
+    char* c_ptr_3 {nullptr};
+    size_t size {256};
+    strat_.alloc(&c_ptr_1, size);
+    strat_.alloc(&c_ptr_2, size);
+    strat_.alloc(&c_ptr_3, size);
+    ASSERT_NE(c_ptr_1, nullptr);
+    ASSERT_NE(c_ptr_2, nullptr);
+    ASSERT_NE(c_ptr_3, nullptr);
+
+    strat_.free(c_ptr_1);
+    strat_.free(c_ptr_2);
+
+    auto bins {strat_.get_bins()};
+    auto &bin {(*bins)[size]};
+    auto &bin_512 {(*bins)[size << 1]};
+    ASSERT_EQ(bin.size(), 1);
+    ASSERT_EQ(bin_512.size(), 1);
+
+    char* c_ptr_4 {nullptr};
+    strat_.alloc(&c_ptr_4, size << 1);
+    ASSERT_EQ(c_ptr_4, std::min(c_ptr_1, c_ptr_2));
+}
+
+TEST_F(Pow2BinsTestFixture, fragment_then_alloc_1GB)
+{
+    size_t size {1 << 20};
+    size_t num_blocks {(size_t{1} << 30) / size};
+
+    std::vector<char*> ptrs(num_blocks, nullptr);
+    for (auto& ptr : ptrs) {
+        strat_.alloc(&ptr, size);
+        ASSERT_NE(ptr, nullptr);
+    }
+
+    char* c_ptr {nullptr};
+    strat_.alloc(&c_ptr, size);
+    ASSERT_EQ(c_ptr, nullptr);
+
+    /*
+     * Release every other block first so no buddies can be combined
+     * until the second pass.
+     */
+    for (size_t i {0}; i < num_blocks; i += 2) {
+        strat_.free(ptrs[i]);
+    }
+
+    strat_.alloc(&c_ptr, size << 1);
+    ASSERT_EQ(c_ptr, nullptr);
+
+    for (size_t i {1}; i < num_blocks; i += 2) {
+        strat_.free(ptrs[i]);
+    }
+
+    ASSERT_EQ(strat_.amount_proffered(), 0);
+
+    strat_.alloc(&c_ptr, size_t{1} << 30);
+    ASSERT_NE(c_ptr, nullptr);
+}
+
+TEST_F(Pow2BinsTestFixture, mixed_size_churn_then_alloc_1GB)
+{
+    std::vector<char*> ptrs {};
+    for (size_t iteration {0}; iteration < 4; iteration++) {
+        for (size_t size {ALIGNMENT}; size <= (1 << 24); size <<= 1) {
+            char* c_ptr {nullptr};
+            strat_.alloc(&c_ptr, size + iteration);
+            ASSERT_NE(c_ptr, nullptr);
+            ptrs.push_back(c_ptr);
+        }
+        for (size_t i {iteration % 2}; i < ptrs.size(); i += 2) {
+            strat_.free(ptrs[i]);
+            ptrs[i] = nullptr;
+        }
+        ptrs.erase(std::remove(ptrs.begin(), ptrs.end(), nullptr),
+                   ptrs.end());
+    }
+
+    for (auto ptr : ptrs) {
+        strat_.free(ptr);
+    }
+
+    char* c_ptr {nullptr};
+    strat_.alloc(&c_ptr, size_t{1} << 30);
+    ASSERT_NE(c_ptr, nullptr);
+}
+
+TEST_F(Pow2BinsTestFixture, alloc_aligned_64KB)
+{
+    char* c_ptr_1 {nullptr};
+    strat_.alloc(&c_ptr_1, 256);
+    ASSERT_NE(c_ptr_1, nullptr);
+
+    char* c_ptr_2 {nullptr};
+    size_t alignment {1 << 16};
+    strat_.alloc_aligned(&c_ptr_2, alignment, 256);
+    ASSERT_NE(c_ptr_2, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(c_ptr_2) % alignment, 0);
+    ASSERT_EQ(strat_.proffered_size(c_ptr_2), 256);
+    ASSERT_EQ(strat_.amount_proffered(), 512);
+
+    strat_.free(c_ptr_1);
+    strat_.free(c_ptr_2);
+    ASSERT_EQ(strat_.amount_proffered(), 0);
+
+    auto bins {strat_.get_bins()};
+    auto &top_bin {(*bins)[1 << 30]};
+    ASSERT_EQ(top_bin.size(), 1);
+}
+
+TEST_F(Pow2BinsTestFixture, alloc_aligned_not_pow2)
+{
+    char* c_ptr {nullptr};
+    strat_.alloc_aligned(&c_ptr, 384, 256);
+    ASSERT_EQ(c_ptr, nullptr);
+}
+
+TEST_F(Pow2BinsTestFixture, resize_in_place_grow_and_shrink)
+{
+    char* c_ptr {nullptr};
+    strat_.alloc(&c_ptr, 256);
+    ASSERT_NE(c_ptr, nullptr);
+
+    ASSERT_TRUE(strat_.resize_in_place(c_ptr, 4096));
+    ASSERT_EQ(strat_.proffered_size(c_ptr), 4096);
+    ASSERT_EQ(strat_.amount_proffered(), 4096);
+
+    ASSERT_TRUE(strat_.resize_in_place(c_ptr, 200));
+    ASSERT_EQ(strat_.proffered_size(c_ptr), 256);
+    ASSERT_EQ(strat_.amount_proffered(), 256);
+
+    strat_.free(c_ptr);
+    auto bins {strat_.get_bins()};
+    auto &top_bin {(*bins)[1 << 30]};
+    ASSERT_EQ(top_bin.size(), 1);
+}
+
+TEST_F(Pow2BinsTestFixture, resize_in_place_blocked_by_buddy)
+{
+    char* c_ptr_1 {nullptr};
+    char* c_ptr_2 {nullptr};
+    strat_.alloc(&c_ptr_1, 256);
+    strat_.alloc(&c_ptr_2, 256);
+    ASSERT_EQ(c_ptr_1 + 256, c_ptr_2);
+
+    ASSERT_FALSE(strat_.resize_in_place(c_ptr_1, 512));
+    ASSERT_FALSE(strat_.resize_in_place(c_ptr_2, 512));
+    ASSERT_EQ(strat_.proffered_size(c_ptr_1), 256);
+    ASSERT_EQ(strat_.proffered_size(c_ptr_2), 256);
+}
@@ -25,6 +25,9 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "memory/address_record.hpp"
 #include "memory/heap_memory.hpp"
 #include "memory/hip_allocator.hpp"
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "progress_policy_gtest.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+using namespace rocshmem;
+
+TEST_F(ProgressPolicyTestFixture, policy_from_env)
+{
+    unsetenv("RO_NET_PROGRESS_POLICY");
+    unsetenv("RO_NET_PROGRESS_SLEEP_US");
+    auto policy {ProgressPolicy::from_env()};
+    ASSERT_EQ(policy.mode, ProgressMode::SPIN);
+    ASSERT_EQ(policy.max_sleep.count(), 1000);
+
+    setenv("RO_NET_PROGRESS_POLICY", "yield", 1);
+    ASSERT_EQ(ProgressPolicy::from_env().mode, ProgressMode::YIELD);
+
+    setenv("RO_NET_PROGRESS_POLICY", "sleep", 1);
+    setenv("RO_NET_PROGRESS_SLEEP_US", "250", 1);
+    policy = ProgressPolicy::from_env();
+    ASSERT_EQ(policy.mode, ProgressMode::SLEEP);
+    ASSERT_EQ(policy.max_sleep.count(), 250);
+
+    setenv("RO_NET_PROGRESS_POLICY", "spin", 1);
+    ASSERT_EQ(ProgressPolicy::from_env().mode, ProgressMode::SPIN);
+
+    unsetenv("RO_NET_PROGRESS_POLICY");
+    unsetenv("RO_NET_PROGRESS_SLEEP_US");
+}
+
+TEST_F(ProgressPolicyTestFixture, backoff_spins_before_mode)
+{
+    IdleBackoff spin {ProgressMode::SPIN};
+    IdleBackoff sleep {ProgressMode::SLEEP};
+    for (int i {0}; i < 10; i++) {
+        ASSERT_FALSE(spin.idle());
+        ASSERT_FALSE(sleep.idle());
+    }
+    ASSERT_FALSE(spin.idle());
+    ASSERT_TRUE(sleep.idle());
+    ASSERT_TRUE(sleep.idle());
+
+    sleep.reset();
+    ASSERT_FALSE(sleep.idle());
+}
+
+TEST_F(ProgressPolicyTestFixture, wait_times_out)
+{
+    auto start {std::chrono::steady_clock::now()};
+    doorbell_.wait(doorbell_.arm(), std::chrono::microseconds{2000});
+    auto elapsed {std::chrono::steady_clock::now() - start};
+    ASSERT_GE(elapsed, std::chrono::microseconds{2000});
+}
+
+TEST_F(ProgressPolicyTestFixture, ring_before_wait_is_not_lost)
+{
+    auto ticket {doorbell_.arm()};
+    doorbell_.ring();
+
+    auto start {std::chrono::steady_clock::now()};
+    doorbell_.wait(ticket, std::chrono::seconds{10});
+    auto elapsed {std::chrono::steady_clock::now() - start};
+    ASSERT_LT(elapsed, std::chrono::seconds{1});
+}
+
+TEST_F(ProgressPolicyTestFixture, ring_wakes_waiter)
+{
+    std::atomic<bool> armed {false};
+    std::atomic<bool> woken {false};
+    std::thread waiter([&] {
+        auto ticket {doorbell_.arm()};
+        armed = true;
+        doorbell_.wait(ticket, std::chrono::seconds{10});
+        woken = true;
+    });
+
+    while (!armed) {
+        std::this_thread::yield();
+    }
+    auto start {std::chrono::steady_clock::now()};
+    doorbell_.ring();
+    waiter.join();
+    auto elapsed {std::chrono::steady_clock::now() - start};
+
+    ASSERT_TRUE(woken);
+    ASSERT_LT(elapsed, std::chrono::seconds{1});
+}
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+#include "request_ring_gtest.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace rocshmem;
+
+TEST_F(RequestRingTestFixture, capacity_rounds_up)
+{
+    ASSERT_EQ(ring_.capacity(), 8);
+    ASSERT_EQ(RequestRing<Value>{5}.capacity(), 8);
+    ASSERT_EQ(RequestRing<Value>{0}.capacity(), 2);
+}
+
+TEST_F(RequestRingTestFixture, pop_empty)
+{
+    Value values[4];
+    ASSERT_EQ(ring_.pop(values, 4), 0);
+    ASSERT_EQ(ring_.size(), 0);
+}
+
+TEST_F(RequestRingTestFixture, push_until_full)
+{
+    for (uint64_t i {0}; i < ring_.capacity(); i++) {
+        ASSERT_TRUE(ring_.push({0, i}));
+    }
+    ASSERT_FALSE(ring_.push({0, ring_.capacity()}));
+    ASSERT_EQ(ring_.size(), ring_.capacity());
+}
+
+TEST_F(RequestRingTestFixture, pop_batches_in_order)
+{
+    Value values[8];
+    for (uint64_t lap {0}; lap < 4; lap++) {
+        for (uint64_t i {0}; i < 6; i++) {
+            ASSERT_TRUE(ring_.push({0, lap * 6 + i}));
+        }
+        ASSERT_EQ(ring_.pop(values, 4), 4);
+        ASSERT_EQ(ring_.pop(values + 4, 8), 2);
+        for (uint64_t i {0}; i < 6; i++) {
+            ASSERT_EQ(values[i].index, lap * 6 + i);
+        }
+    }
+    ASSERT_EQ(ring_.size(), 0);
+}
+
+TEST_F(RequestRingTestFixture, multiple_producers)
+{
+    constexpr int num_producers {4};
+    constexpr uint64_t num_pushes {20000};
+
+    std::vector<std::thread> producers;
+    for (int p {0}; p < num_producers; p++) {
+        producers.emplace_back([this, p] {
+            for (uint64_t i {0}; i < num_pushes; i++) {
+                while (!ring_.push({p, i})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(num_producers, 0);
+    uint64_t total {0};
+    Value values[8];
+    while (total < num_producers * num_pushes) {
+        auto count {ring_.pop(values, 8)};
+        if (!count) {
+            std::this_thread::yield();
+        }
+        for (size_t i {0}; i < count; i++) {
+            auto& value {values[i]};
+            ASSERT_EQ(value.index, next[value.producer]);
+            next[value.producer]++;
+        }
+        total += count;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    ASSERT_EQ(ring_.size(), 0);
+}
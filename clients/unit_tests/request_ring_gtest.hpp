@@ -0,0 +1,53 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_REQUEST_RING_GTEST_HPP
+#define ROCSHMEM_REQUEST_RING_GTEST_HPP
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include "reverse_offload/request_ring.hpp"
+
+namespace rocshmem {
+
+class RequestRingTestFixture : public ::testing::Test
+{
+  protected:
+    /**
+     * @brief Value type tagged with the pushing thread
+     */
+    struct Value {
+        int producer {-1};
+        uint64_t index {0};
+    };
+
+    /**
+     * @brief Ring object
+     */
+    RequestRing<Value> ring_ {8};
+};
+
+} // namespace rocshmem
+
+#endif // ROCSHMEM_REQUEST_RING_GTEST_HPP
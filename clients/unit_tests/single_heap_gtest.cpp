@@ -74,7 +74,7 @@ TEST_F(SingleHeapTestFixture, alloc_1)
     single_heap_.malloc(&ptr, request_size);
     ASSERT_NE(ptr, nullptr);
 
-    size_t expected_used {128};
+    size_t expected_used {8};
     ASSERT_EQ(single_heap_.get_used(), expected_used);
     size_t expected_avail {single_heap_.get_size() - expected_used};
     ASSERT_EQ(single_heap_.get_avail(), expected_avail);
@@ -149,3 +149,298 @@ TEST_F(SingleHeapTestFixture, alloc_4097)
     expected_avail = single_heap_.get_size();
     ASSERT_EQ(single_heap_.get_avail(), expected_avail);
 }
+
+TEST_F(SingleHeapTestFixture, realloc_nullptr_allocates)
+{
+    void* ptr {single_heap_.realloc(nullptr, 256)};
+    ASSERT_NE(ptr, nullptr);
+    ASSERT_EQ(single_heap_.get_used(), 256);
+
+    ASSERT_EQ(single_heap_.realloc(ptr, 0), nullptr);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, realloc_grows_in_place)
+{
+    /*
+     * Binned sizes are refilled in batches, which keeps their buddies
+     * busy, so grow a block that bypasses the bins.
+     */
+    constexpr size_t size {size_t{2} << SizeClassBins::MAX_LEVEL};
+
+    void* ptr {nullptr};
+    single_heap_.malloc(&ptr, size);
+    ASSERT_NE(ptr, nullptr);
+
+    void* new_ptr {single_heap_.realloc(ptr, 4 * size)};
+    ASSERT_EQ(new_ptr, ptr);
+    ASSERT_EQ(single_heap_.get_used(), 4 * size);
+
+    single_heap_.free(new_ptr);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, realloc_copies_when_buddy_in_use)
+{
+    void* ptr_1 {nullptr};
+    void* ptr_2 {nullptr};
+    single_heap_.malloc(&ptr_1, 256);
+    single_heap_.malloc(&ptr_2, 256);
+    ASSERT_NE(ptr_1, nullptr);
+    ASSERT_NE(ptr_2, nullptr);
+
+    std::vector<char> pattern(256);
+    std::iota(pattern.begin(), pattern.end(), 0);
+    CHECK_HIP(hipMemcpy(ptr_1, pattern.data(), pattern.size(),
+                        hipMemcpyDefault));
+
+    void* new_ptr {single_heap_.realloc(ptr_1, 1024)};
+    ASSERT_NE(new_ptr, nullptr);
+    ASSERT_NE(new_ptr, ptr_1);
+    ASSERT_EQ(single_heap_.get_used(), 1024 + 256);
+
+    std::vector<char> result(256);
+    CHECK_HIP(hipMemcpy(result.data(), new_ptr, result.size(),
+                        hipMemcpyDefault));
+    ASSERT_EQ(pattern, result);
+
+    single_heap_.free(new_ptr);
+    single_heap_.free(ptr_2);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, malign_4KB)
+{
+    void* ptr_1 {nullptr};
+    single_heap_.malloc(&ptr_1, 1);
+
+    size_t alignment {4096};
+    void* ptr_2 {single_heap_.malign(alignment, 128)};
+    ASSERT_NE(ptr_2, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr_2) % alignment, 0);
+    ASSERT_EQ(single_heap_.get_used(), 8 + 128);
+
+    single_heap_.free(ptr_1);
+    single_heap_.free(ptr_2);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, small_allocs_share_slab)
+{
+    std::vector<void*> ptrs(64, nullptr);
+    for (auto& ptr : ptrs) {
+        single_heap_.malloc(&ptr, 4);
+        ASSERT_NE(ptr, nullptr);
+    }
+
+    auto base {reinterpret_cast<char*>(ptrs.front())};
+    for (size_t i {0}; i < ptrs.size(); i++) {
+        ASSERT_EQ(reinterpret_cast<char*>(ptrs[i]), base + i * 8);
+    }
+
+    ASSERT_EQ(single_heap_.get_used(), 64 * 8);
+    ASSERT_EQ(single_heap_.get_slab_unused(), 4096 - 64 * 8);
+    ASSERT_EQ(single_heap_.get_avail(), single_heap_.get_size() - 64 * 8);
+
+    for (auto ptr : ptrs) {
+        single_heap_.free(ptr);
+    }
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, realloc_from_slab_to_block)
+{
+    void* ptr {nullptr};
+    single_heap_.malloc(&ptr, 16);
+    ASSERT_NE(ptr, nullptr);
+
+    std::vector<char> pattern(16);
+    std::iota(pattern.begin(), pattern.end(), 0);
+    CHECK_HIP(hipMemcpy(ptr, pattern.data(), pattern.size(),
+                        hipMemcpyDefault));
+
+    ASSERT_EQ(single_heap_.realloc(ptr, 12), ptr);
+
+    void* new_ptr {single_heap_.realloc(ptr, 1024)};
+    ASSERT_NE(new_ptr, nullptr);
+    ASSERT_EQ(single_heap_.get_used(), 1024);
+
+    std::vector<char> result(16);
+    CHECK_HIP(hipMemcpy(result.data(), new_ptr, result.size(),
+                        hipMemcpyDefault));
+    ASSERT_EQ(pattern, result);
+
+    single_heap_.free(new_ptr);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, freed_block_reused_from_cache)
+{
+    void* ptr {nullptr};
+    single_heap_.malloc(&ptr, 1024);
+    ASSERT_NE(ptr, nullptr);
+
+    single_heap_.free(ptr);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+
+    void* again {nullptr};
+    single_heap_.malloc(&again, 1000);
+    ASSERT_EQ(again, ptr);
+
+    single_heap_.free(again);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, cached_blocks_released_when_heap_exhausted)
+{
+    std::vector<void*> ptrs(SizeClassBins::DEPTH, nullptr);
+    for (auto& ptr : ptrs) {
+        single_heap_.malloc(&ptr, 4096);
+        ASSERT_NE(ptr, nullptr);
+    }
+    for (auto ptr : ptrs) {
+        single_heap_.free(ptr);
+    }
+
+    void* whole_heap {nullptr};
+    single_heap_.malloc(&whole_heap, single_heap_.get_size());
+    ASSERT_NE(whole_heap, nullptr);
+    ASSERT_EQ(single_heap_.get_avail(), 0);
+
+    single_heap_.free(whole_heap);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+}
+
+TEST_F(SingleHeapTestFixture, multithreaded_stress)
+{
+    constexpr int num_threads {8};
+    constexpr int iterations {20000};
+    constexpr size_t sizes[] {8, 24, 64, 200, 1024, 5000, 70000};
+
+    /*
+     * Live allocations from every thread. Each new allocation is checked
+     * against its neighbours for overlap.
+     */
+    std::mutex live_mutex;
+    std::map<char*, size_t> live;
+    std::atomic<int> failures {0};
+
+    auto track = [&](char* ptr, size_t size) {
+        std::lock_guard<std::mutex> lock {live_mutex};
+        auto next {live.lower_bound(ptr)};
+        if (next != live.end() && next->first < ptr + size) {
+            failures++;
+        }
+        if (next != live.begin()) {
+            auto prev {std::prev(next)};
+            if (prev->first + prev->second > ptr) {
+                failures++;
+            }
+        }
+        live[ptr] = size;
+    };
+
+    auto untrack = [&](char* ptr) {
+        std::lock_guard<std::mutex> lock {live_mutex};
+        live.erase(ptr);
+    };
+
+    auto worker = [&](int id) {
+        std::mt19937 gen(id);
+        std::uniform_int_distribution<size_t> pick(0, std::size(sizes) - 1);
+        std::vector<void*> mine;
+        for (int i {0}; i < iterations; i++) {
+            if (mine.size() < 16 && (mine.empty() || gen() % 2)) {
+                void* ptr {nullptr};
+                auto size {sizes[pick(gen)]};
+                single_heap_.malloc(&ptr, size);
+                if (!ptr) {
+                    failures++;
+                    continue;
+                }
+                track(reinterpret_cast<char*>(ptr), size);
+                mine.push_back(ptr);
+            } else {
+                auto index {gen() % mine.size()};
+                untrack(reinterpret_cast<char*>(mine[index]));
+                single_heap_.free(mine[index]);
+                mine[index] = mine.back();
+                mine.pop_back();
+            }
+        }
+        for (auto ptr : mine) {
+            untrack(reinterpret_cast<char*>(ptr));
+            single_heap_.free(ptr);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int id {0}; id < num_threads; id++) {
+        threads.emplace_back(worker, id);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(failures, 0);
+    ASSERT_EQ(single_heap_.get_used(), 0);
+
+    /*
+     * Each slab size class keeps one partial slab, so check that the
+     * remaining blocks coalesced instead of requesting the whole heap.
+     */
+    void* half_heap {nullptr};
+    single_heap_.malloc(&half_heap, single_heap_.get_size() / 2);
+    ASSERT_NE(half_heap, nullptr);
+    single_heap_.free(half_heap);
+}
+
+TEST_F(SingleHeapTestFixture, benchmark_multithreaded_alloc_free)
+{
+    constexpr int iterations {100000};
+
+    /*
+     * Each thread allocates its own block size so that the threads only
+     * share the heap, not a bin; aggregate throughput should then grow
+     * with the thread count up to the number of hardware threads.
+     */
+    double single_thread_rate {0};
+    for (int num_threads : {1, 2, 4, 8}) {
+        auto worker = [&](int id) {
+            size_t size {size_t{256} << id};
+            for (int i {0}; i < iterations; i++) {
+                void* ptr {nullptr};
+                single_heap_.malloc(&ptr, size);
+                single_heap_.free(ptr);
+            }
+        };
+
+        auto start {std::chrono::steady_clock::now()};
+        std::vector<std::thread> threads;
+        for (int id {0}; id < num_threads; id++) {
+            threads.emplace_back(worker, id);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end {std::chrono::steady_clock::now()};
+
+        ASSERT_EQ(single_heap_.get_used(), 0);
+
+        std::chrono::duration<double> seconds {end - start};
+        double rate {double{iterations} * num_threads / seconds.count()};
+        if (num_threads == 1) {
+            single_thread_rate = rate;
+        }
+        double speedup {rate / single_thread_rate};
+        std::cout << "[ BENCH    ] " << num_threads << " thread(s) "
+                  << rate / 1e6 << " M alloc/free pairs/s, speedup "
+                  << speedup << "x" << std::endl;
+
+        if (num_threads > 1 &&
+            static_cast<unsigned>(num_threads) <=
+                std::thread::hardware_concurrency()) {
+            EXPECT_GT(speedup, 1.0);
+        }
+    }
+}
@@ -25,7 +25,19 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
 #include "memory/single_heap.hpp"
+#include "util.hpp"
 
 namespace rocshmem {
 
@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "size_class_bins_gtest.hpp"
+
+using namespace rocshmem;
+
+TEST_F(SizeClassBinsTestFixture, caches)
+{
+    ASSERT_FALSE(SizeClassBins::caches(0));
+    ASSERT_FALSE(SizeClassBins::caches(4));
+    ASSERT_TRUE(SizeClassBins::caches(8));
+    ASSERT_FALSE(SizeClassBins::caches(24));
+    ASSERT_TRUE(SizeClassBins::caches(4096));
+    ASSERT_TRUE(SizeClassBins::caches(size_t{1} << SizeClassBins::MAX_LEVEL));
+    ASSERT_FALSE(SizeClassBins::caches(size_t{2} << SizeClassBins::MAX_LEVEL));
+}
+
+TEST_F(SizeClassBinsTestFixture, get_empty)
+{
+    char* ptr {nullptr};
+    ASSERT_FALSE(bins_.get(128, &ptr));
+    ASSERT_EQ(ptr, nullptr);
+}
+
+TEST_F(SizeClassBinsTestFixture, put_get_lifo)
+{
+    SizeClassBins::Batch evicted;
+    ASSERT_EQ(bins_.put(128, block(0), &evicted), 0);
+    ASSERT_EQ(bins_.put(128, block(1), &evicted), 0);
+    ASSERT_EQ(bins_.amount_cached(), 256);
+
+    char* ptr {nullptr};
+    ASSERT_FALSE(bins_.get(256, &ptr));
+    ASSERT_TRUE(bins_.get(128, &ptr));
+    ASSERT_EQ(ptr, block(1));
+    ASSERT_TRUE(bins_.get(128, &ptr));
+    ASSERT_EQ(ptr, block(0));
+    ASSERT_EQ(bins_.amount_cached(), 0);
+}
+
+TEST_F(SizeClassBinsTestFixture, full_level_evicts_oldest_half)
+{
+    SizeClassBins::Batch evicted;
+    for (size_t i {0}; i < SizeClassBins::DEPTH; i++) {
+        ASSERT_EQ(bins_.put(1024, block(i), &evicted), 0);
+    }
+
+    auto new_block {block(SizeClassBins::DEPTH)};
+    ASSERT_EQ(bins_.put(1024, new_block, &evicted), evicted.size());
+    for (size_t i {0}; i < evicted.size(); i++) {
+        ASSERT_EQ(evicted[i], block(i));
+    }
+
+    auto num_left {SizeClassBins::DEPTH - evicted.size() + 1};
+    ASSERT_EQ(bins_.amount_cached(), num_left * 1024);
+
+    char* ptr {nullptr};
+    ASSERT_TRUE(bins_.get(1024, &ptr));
+    ASSERT_EQ(ptr, new_block);
+}
+
+TEST_F(SizeClassBinsTestFixture, drain)
+{
+    SizeClassBins::Batch evicted;
+    bins_.put(8, block(0), &evicted);
+    bins_.put(4096, block(1), &evicted);
+
+    std::vector<char*> blocks;
+    bins_.drain(&blocks);
+    ASSERT_EQ(blocks.size(), 2);
+    ASSERT_EQ(bins_.amount_cached(), 0);
+
+    char* ptr {nullptr};
+    ASSERT_FALSE(bins_.get(8, &ptr));
+    ASSERT_FALSE(bins_.get(4096, &ptr));
+}
+
+TEST_F(SizeClassBinsTestFixture, fill_hands_out_in_order)
+{
+    std::vector<char*> blocks;
+    for (size_t i {0}; i < SizeClassBins::DEPTH + 2; i++) {
+        blocks.push_back(block(i));
+    }
+    ASSERT_EQ(bins_.fill(512, blocks.data(), blocks.size()),
+              SizeClassBins::DEPTH);
+    ASSERT_EQ(bins_.amount_cached(), SizeClassBins::DEPTH * 512);
+
+    char* ptr {nullptr};
+    for (size_t i {0}; i < SizeClassBins::DEPTH; i++) {
+        ASSERT_TRUE(bins_.get(512, &ptr));
+        ASSERT_EQ(ptr, block(i));
+    }
+    ASSERT_FALSE(bins_.get(512, &ptr));
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_SIZE_CLASS_BINS_GTEST_HPP
+#define ROCSHMEM_SIZE_CLASS_BINS_GTEST_HPP
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "memory/size_class_bins.hpp"
+
+namespace rocshmem {
+
+class SizeClassBinsTestFixture : public ::testing::Test
+{
+  protected:
+    /**
+     * @brief Fake block address for an index
+     *
+     * The bins never dereference blocks, so any distinct addresses do.
+     *
+     * @param[in] Index of the block
+     *
+     * @return Raw pointer
+     */
+    char*
+    block(size_t index) {
+        return reinterpret_cast<char*>((index + 1) << 20);
+    }
+
+    /**
+     * @brief Size class bins object
+     */
+    SizeClassBins bins_ {};
+};
+
+} // namespace rocshmem
+
+#endif // ROCSHMEM_SIZE_CLASS_BINS_GTEST_HPP
@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#include "slab_allocator_gtest.hpp"
+
+using namespace rocshmem;
+
+TEST_F(SlabAllocatorTestFixture, handles)
+{
+    ASSERT_FALSE(SLAB_T::handles(0));
+    ASSERT_TRUE(SLAB_T::handles(1));
+    ASSERT_TRUE(SLAB_T::handles(SLAB_T::MAX_CLASS_SIZE));
+    ASSERT_FALSE(SLAB_T::handles(SLAB_T::MAX_CLASS_SIZE + 1));
+}
+
+TEST_F(SlabAllocatorTestFixture, size_classes)
+{
+    char* c_ptr {nullptr};
+    slab_.alloc(&c_ptr, 1);
+    ASSERT_EQ(slab_.object_size(c_ptr), 8);
+    slab_.alloc(&c_ptr, 9);
+    ASSERT_EQ(slab_.object_size(c_ptr), 16);
+    slab_.alloc(&c_ptr, 32);
+    ASSERT_EQ(slab_.object_size(c_ptr), 32);
+    slab_.alloc(&c_ptr, 33);
+    ASSERT_EQ(slab_.object_size(c_ptr), 64);
+
+    ASSERT_EQ(strat_.amount_proffered(), 4 * SLAB_T::SLAB_SIZE);
+    ASSERT_EQ(slab_.amount_unused(),
+              4 * SLAB_T::SLAB_SIZE - (8 + 16 + 32 + 64));
+}
+
+TEST_F(SlabAllocatorTestFixture, dense_packing)
+{
+    size_t object_size {8};
+    size_t num_objects {SLAB_T::SLAB_SIZE / object_size};
+
+    std::vector<char*> ptrs(num_objects, nullptr);
+    for (auto& ptr : ptrs) {
+        slab_.alloc(&ptr, object_size);
+        ASSERT_NE(ptr, nullptr);
+    }
+    for (size_t i {1}; i < num_objects; i++) {
+        ASSERT_EQ(ptrs[i], ptrs[0] + i * object_size);
+    }
+    ASSERT_EQ(strat_.amount_proffered(), SLAB_T::SLAB_SIZE);
+    ASSERT_EQ(slab_.amount_unused(), 0);
+
+    char* c_ptr {nullptr};
+    slab_.alloc(&c_ptr, object_size);
+    ASSERT_NE(c_ptr, nullptr);
+    ASSERT_EQ(strat_.amount_proffered(), 2 * SLAB_T::SLAB_SIZE);
+}
+
+TEST_F(SlabAllocatorTestFixture, owns)
+{
+    char* block {nullptr};
+    strat_.alloc(&block, 4096);
+    ASSERT_FALSE(slab_.owns(block));
+
+    char* c_ptr {nullptr};
+    slab_.alloc(&c_ptr, 8);
+    ASSERT_TRUE(slab_.owns(c_ptr));
+    ASSERT_TRUE(slab_.owns(c_ptr + 8));
+}
+
+TEST_F(SlabAllocatorTestFixture, free_reuses_lowest_object)
+{
+    char* c_ptr_1 {nullptr};
+    char* c_ptr_2 {nullptr};
+    slab_.alloc(&c_ptr_1, 8);
+    slab_.alloc(&c_ptr_2, 8);
+
+    slab_.free(c_ptr_1);
+    char* c_ptr_3 {nullptr};
+    slab_.alloc(&c_ptr_3, 8);
+    ASSERT_EQ(c_ptr_3, c_ptr_1);
+}
+
+TEST_F(SlabAllocatorTestFixture, empty_slabs_returned_to_strategy)
+{
+    size_t object_size {64};
+    size_t num_objects {SLAB_T::SLAB_SIZE / object_size};
+
+    std::vector<char*> ptrs(3 * num_objects, nullptr);
+    for (auto& ptr : ptrs) {
+        slab_.alloc(&ptr, object_size);
+        ASSERT_NE(ptr, nullptr);
+    }
+    ASSERT_EQ(strat_.amount_proffered(), 3 * SLAB_T::SLAB_SIZE);
+
+    for (auto ptr : ptrs) {
+        slab_.free(ptr);
+    }
+
+    /*
+     * One empty slab is kept to avoid thrashing on alloc/free cycles.
+     */
+    ASSERT_EQ(strat_.amount_proffered(), SLAB_T::SLAB_SIZE);
+    ASSERT_EQ(slab_.amount_unused(), SLAB_T::SLAB_SIZE);
+}
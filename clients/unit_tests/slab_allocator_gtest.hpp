@@ -0,0 +1,75 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_SLAB_ALLOCATOR_GTEST_HPP
+#define ROCSHMEM_SLAB_ALLOCATOR_GTEST_HPP
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "memory/address_record.hpp"
+#include "memory/heap_memory.hpp"
+#include "memory/hip_allocator.hpp"
+#include "memory/pow2_bins.hpp"
+#include "memory/slab_allocator.hpp"
+
+namespace rocshmem {
+
+class SlabAllocatorTestFixture : public ::testing::Test
+{
+  protected:
+    /**
+     * @brief Helper type for heap memory
+     */
+    using HEAP_T = HeapMemory<HIPAllocator>;
+
+    /**
+     * @brief Helper type for allocation strategy
+     */
+    using STRAT_T = Pow2Bins<AddressRecord, HEAP_T>;
+
+    /**
+     * @brief Helper type for slab allocator
+     */
+    using SLAB_T = SlabAllocator<STRAT_T>;
+
+    /**
+     * @brief Heap memory object
+     */
+    HEAP_T heap_mem_ {};
+
+    /**
+     * @brief Allocation strategy object
+     */
+    STRAT_T strat_ {&heap_mem_};
+
+    /**
+     * @brief Slab allocator object
+     */
+    SLAB_T slab_ {&strat_};
+};
+
+} // namespace rocshmem
+
+#endif // ROCSHMEM_SLAB_ALLOCATOR_GTEST_HPP
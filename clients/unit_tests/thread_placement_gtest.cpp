@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "thread_placement_gtest.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace rocshmem;
+
+TEST_F(ThreadPlacementTestFixture, parse_cpu_list)
+{
+    ASSERT_EQ(parse_cpu_list("0"), std::vector<int>({0}));
+    ASSERT_EQ(parse_cpu_list("0-3,8"), std::vector<int>({0, 1, 2, 3, 8}));
+    ASSERT_EQ(parse_cpu_list("10-11,4"), std::vector<int>({10, 11, 4}));
+    ASSERT_EQ(parse_cpu_list(" 2 - 3 "), std::vector<int>({2, 3}));
+    ASSERT_TRUE(parse_cpu_list("").empty());
+}
+
+TEST_F(ThreadPlacementTestFixture, parse_malformed_cpu_list)
+{
+    ASSERT_TRUE(parse_cpu_list("3-1").empty());
+    ASSERT_TRUE(parse_cpu_list("-1").empty());
+    ASSERT_TRUE(parse_cpu_list("0,,1").empty());
+    ASSERT_TRUE(parse_cpu_list("0-").empty());
+    ASSERT_TRUE(parse_cpu_list("1x").empty());
+    ASSERT_TRUE(parse_cpu_list("0-3x").empty());
+}
+
+TEST_F(ThreadPlacementTestFixture, placement_from_env)
+{
+    auto placement {ThreadPlacement::from_env("RO_NET_POLLER_CPUS")};
+    ASSERT_TRUE(placement.cpus.empty());
+
+    setenv("RO_NET_POLLER_CPUS", "1-2", 1);
+    placement = ThreadPlacement::from_env("RO_NET_POLLER_CPUS");
+    ASSERT_EQ(placement.cpus, std::vector<int>({1, 2}));
+    ASSERT_TRUE(placement.one_cpu_per_thread);
+
+    setenv("RO_NET_POLLER_CPUS", "bogus", 1);
+    placement = ThreadPlacement::from_env("RO_NET_POLLER_CPUS");
+    ASSERT_TRUE(placement.cpus.empty());
+}
+
+TEST_F(ThreadPlacementTestFixture, apply_pins_thread)
+{
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int cpu {0};
+    while (!CPU_ISSET(cpu, &allowed)) {
+        cpu++;
+    }
+
+    ThreadPlacement placement {};
+    placement.cpus = {cpu};
+    placement.one_cpu_per_thread = true;
+
+    std::atomic<bool> placed {false};
+    std::thread thread {[&placed] {
+        while (!placed) {
+            std::this_thread::yield();
+        }
+    }};
+    placement.apply(thread, 3);
+
+    cpu_set_t cpu_set;
+    ASSERT_EQ(pthread_getaffinity_np(thread.native_handle(),
+                                     sizeof(cpu_set),
+                                     &cpu_set), 0);
+    placed = true;
+    thread.join();
+    ASSERT_EQ(CPU_COUNT(&cpu_set), 1);
+    ASSERT_TRUE(CPU_ISSET(cpu, &cpu_set));
+}
@@ -110,6 +110,12 @@ const int ROC_SHMEM_CTX_PRIVATE = 2;
 const int ROC_SHMEM_CTX_NOSTORE = 4;
 const int ROC_SHMEM_CTX_WG_PRIVATE = 8;
 
+/**
+ * @brief Hints for roc_shmem_malloc_with_hints (OpenSHMEM 1.5).
+ */
+const long ROC_SHMEM_MALLOC_ATOMICS_REMOTE = 1;
+const long ROC_SHMEM_MALLOC_SIGNAL_REMOTE = 2;
+
 /**
  * @brief GPU side OpenSHMEM context created from each work-groups'
  * roc_shmem_wg_handle_t
@@ -205,6 +211,21 @@ roc_shmem_finalize();
 __host__ void*
 roc_shmem_malloc(size_t size);
 
+/**
+ * @brief Allocate memory of \p size bytes from the symmetric heap.
+ * Hints are advisory; the memory currently comes from the same heap as
+ * roc_shmem_malloc.
+ * This is a collective operation and must be called by all PEs.
+ *
+ * @param[in] size Memory allocation size in bytes.
+ * @param[in] hints Bitwise OR of ROC_SHMEM_MALLOC_* hints or 0.
+ *
+ * @return A pointer to the allocated memory on the symmetric heap or
+ * nullptr if the request cannot be satisfied.
+ */
+__host__ void*
+roc_shmem_malloc_with_hints(size_t size, long hints);
+
 /**
  * @brief Free a memory allocation from the symmetric heap.
  * This is a collective operation and must be called by all PEs.
@@ -216,6 +237,37 @@ roc_shmem_malloc(size_t size);
 __host__ void
 roc_shmem_free(void* ptr);
 
+/**
+ * @brief Resize a memory allocation from the symmetric heap to \p size
+ * bytes. The allocation is resized in place when possible; otherwise the
+ * contents are copied to a new allocation and the old one is freed.
+ * This is a collective operation and must be called by all PEs.
+ *
+ * @param[in] ptr Pointer to previously allocated memory on the symmetric
+ *                heap. If nullptr, behaves like roc_shmem_malloc.
+ * @param[in] size New memory allocation size in bytes. If zero, behaves
+ *                 like roc_shmem_free.
+ *
+ * @return A pointer to the resized memory on the symmetric heap or
+ * nullptr if the request cannot be satisfied (\p ptr remains valid).
+ */
+__host__ void*
+roc_shmem_realloc(void* ptr, size_t size);
+
+/**
+ * @brief Allocate memory of \p size bytes from the symmetric heap with
+ * the address aligned to \p alignment bytes.
+ * This is a collective operation and must be called by all PEs.
+ *
+ * @param[in] alignment Required alignment; must be a power of two.
+ * @param[in] size Memory allocation size in bytes.
+ *
+ * @return A pointer to the allocated memory on the symmetric heap or
+ * nullptr if the request cannot be satisfied.
+ */
+__host__ void*
+roc_shmem_align(size_t alignment, size_t size);
+
 /**
  * @brief Query for the number of PEs.
  *
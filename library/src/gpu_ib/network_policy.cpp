@@ -408,11 +408,15 @@ NetworkOnImpl::networkHostSetup(GPUIBBackend *B) {
                                B->thread_comm);
     assert(status == Status::ROC_SHMEM_SUCCESS);
 
+    /*
+     * Lazy heaps are not backed by memory until blocks are handed out,
+     * so they are registered for on-demand paging like managed heaps.
+     */
     const auto& heap_bases {B->heap.get_heap_bases()};
     status = heap_memory_rkey(heap_bases[my_pe],
                               B->heap.get_size(),
                               B->thread_comm,
-                              B->heap.is_managed());
+                              B->heap.is_managed() || B->heap.is_lazy());
     assert(status == Status::ROC_SHMEM_SUCCESS);
     // The earliest we can allow the main thread to launch a kernel to
     // avoid potential deadlock
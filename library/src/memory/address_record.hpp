@@ -129,6 +129,16 @@ class AddressRecord {
         return record;
     }
 
+    /**
+     * @brief Equality comparison
+     *
+     * @return true if both records hold the same address and size
+     */
+    bool
+    operator==(const AR_T& other) const {
+        return address_ == other.address_ && size_ == other.size_;
+    }
+
   private:
     /**
      * @brief raw memory pointer
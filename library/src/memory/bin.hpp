@@ -23,72 +23,121 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_MEMORY_BIN_HPP
 #define ROCSHMEM_LIBRARY_SRC_MEMORY_BIN_HPP
 
-#include <stack>
-
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "block_table.hpp"
 
 /**
  * @file bin.hpp
  *
- * @brief Simple container class
+ * @brief Intrusive free list of heap blocks
  *
- * The class wraps a stack and provides simple mutators. A different internal
- * container class might be preferable to a stack.
+ * The bin only stores the head of a doubly-linked list. The links live in
+ * a BlockTable indexed by slot, so put, get and remove are constant time
+ * and never allocate.
  */
 
 namespace rocshmem {
 
-template <typename T>
 class Bin {
   public:
     /**
-     * @brief Is stack empty?
+     * @brief Is list empty?
      *
-     * @return A boolean denoting stack emptiness
+     * @return A boolean denoting list emptiness
      */
     bool
-    empty() {
-        return stack_.empty();
+    empty() const {
+        return head_ == BlockTable::NIL;
     }
 
     /**
-     * @brief How many elements in stack?
+     * @brief How many slots in list?
      *
-     * @return The number of elements in the stack
+     * @return The number of slots in the list
      */
     size_t
-    size() {
-        return stack_.size();
+    size() const {
+        return size_;
     }
 
     /**
-     * @brief Emplace an element in stack
+     * @brief Accessor for the slot at the front of the list
      *
-     * @param[in] An element
+     * @return Slot index or BlockTable::NIL if the list is empty
+     */
+    uint32_t
+    front() const {
+        return head_;
+    }
+
+    /**
+     * @brief Push a slot onto the front of the list
+     *
+     * @param[in] Block table holding the links
+     * @param[in] Slot index
      */
     void
-    put(T element) {
-        stack_.emplace(element);
+    put(BlockTable* table, uint32_t slot) {
+        table->next(slot) = head_;
+        table->prev(slot) = BlockTable::NIL;
+        if (head_ != BlockTable::NIL) {
+            table->prev(head_) = slot;
+        }
+        head_ = slot;
+        size_++;
     }
 
     /**
-     * @brief Retrieve an element from stack
+     * @brief Pop the slot at the front of the list
      *
-     * @return An element
+     * @param[in] Block table holding the links
+     *
+     * @return Slot index
      */
-    T
-    get() {
-        assert(stack_.size());
-        auto top = stack_.top();
-        stack_.pop();
-        return top;
+    uint32_t
+    get(BlockTable* table) {
+        assert(!empty());
+        auto slot {head_};
+        remove(table, slot);
+        return slot;
+    }
+
+    /**
+     * @brief Unlink a slot from anywhere in the list
+     *
+     * @param[in] Block table holding the links
+     * @param[in] Slot index which must be in this list
+     */
+    void
+    remove(BlockTable* table, uint32_t slot) {
+        assert(size_);
+        auto next {table->next(slot)};
+        auto prev {table->prev(slot)};
+        if (prev != BlockTable::NIL) {
+            table->next(prev) = next;
+        } else {
+            assert(head_ == slot);
+            head_ = next;
+        }
+        if (next != BlockTable::NIL) {
+            table->prev(next) = prev;
+        }
+        size_--;
     }
 
   private:
     /**
-     * @brief Implementation container
+     * @brief Slot index at the front of the list
+     */
+    uint32_t head_ {BlockTable::NIL};
+
+    /**
+     * @brief Number of slots in the list
      */
-    std::stack<T> stack_ {};
+    size_t size_ {0};
 };
 
 } // namespace rocshmem
@@ -23,13 +23,13 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_BINNER_HPP
 #define ROCSHMEM_LIBRARY_SRC_BINNER_HPP
 
-#include <bit>
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 #include <cassert>
 #include <climits>
 
-#include "bin.hpp"
 #include "constants.hpp"
 
 /**
@@ -138,7 +138,7 @@ class Binner {
         std::generate(v.begin(), v.end(), pow2);
 
         for (auto x : v) {
-            bins_->insert({x, Bin<AR_T>{}});
+            bins_->insert(x);
         }
     }
 
@@ -152,6 +152,7 @@ class Binner {
         assert(heap_.get_size());
 
         ignore_unaligned_heap_memory();
+        bins_->attach_heap(heap_.get_address(), heap_.get_size());
         assign_heap_memory_to_bins();
     }
 
@@ -167,17 +168,24 @@ class Binner {
         return bins_;
     }
 
+    /**
+     * @brief Accessor for heap_ record
+     *
+     * @return Address record covering the aligned heap memory
+     *
+     * @note Only valid after assign_heap_to_bins has been invoked
+     */
+    AR_T
+    get_heap() {
+        return heap_;
+    }
+
     /**
      * @brief Dump the bins_ object to the standard out
      */
     void
     dump_bins() {
-        auto dump_bin = [](const auto& pair) {
-           auto [address, bin] = pair;
-           std::cout << "address " << address
-                     << " bin.size " << bin.size() << std::endl;
-        };
-        std::for_each(bins_->begin(), bins_->end(), dump_bin);
+        bins_->dump();
     }
 
   private:
@@ -226,22 +234,17 @@ class Binner {
         char* memory_chunk {address_record.get_address()};
         size_t memory_chunk_size {address_record.get_size()};
 
-        auto rit {bins_->rbegin()};
-        auto rend {bins_->rend()};
-        while (rit != rend) {
-            auto& [bin_memory_chunk_size, bin] = *rit;
-            if (memory_chunk_size >= bin_memory_chunk_size) {
-                break;
-            }
-            rit++;
-        }
-
-        if (rit == rend) {
+        if (memory_chunk_size < bins_->smallest_bin_size()) {
             return {nullptr, 0};
         }
 
-        auto& [bin_memory_chunk_size, bin] = *rit;
-        bin.put({memory_chunk, bin_memory_chunk_size});
+        size_t bin_memory_chunk_size {
+            size_t{1} << find_first_set_one(memory_chunk_size)};
+        bin_memory_chunk_size = std::min(bin_memory_chunk_size,
+                                         bins_->largest_bin_size());
+
+        bins_->put(bin_memory_chunk_size,
+                   {memory_chunk, bin_memory_chunk_size});
 
         return {memory_chunk + bin_memory_chunk_size,
                 memory_chunk_size - bin_memory_chunk_size};
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_LIBRARY_SRC_MEMORY_BLOCK_TABLE_HPP
+#define ROCSHMEM_LIBRARY_SRC_MEMORY_BLOCK_TABLE_HPP
+
+#include <memory>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file block_table.hpp
+ *
+ * @brief Contains side arrays describing heap blocks
+ *
+ * The heap is divided into slots of the minimum block size. Every block
+ * starts on a slot boundary, so a block can be described by the entry at
+ * its first slot. Each entry holds a tag (free, proffered or slab plus a
+ * size level) and the links used by the intrusive free lists.
+ *
+ * The heap memory itself may not be host accessible, so the metadata is
+ * kept in these host arrays instead of inside the blocks. The arrays are
+ * allocated once when the heap is attached; allocation and free never
+ * call the system allocator afterwards.
+ */
+
+namespace rocshmem {
+
+class BlockTable {
+  public:
+    /**
+     * @brief Link value denoting the end of a list
+     */
+    static constexpr uint32_t NIL {UINT32_MAX};
+
+    /**
+     * @brief Required for default construction of other objects
+     *
+     * @note Not intended for direct usage.
+     */
+    BlockTable() = default;
+
+    /**
+     * @brief Primary constructor type
+     *
+     * The tags are zero initialized. The links are left uninitialized so
+     * their pages are only touched for slots which join a free list.
+     *
+     * @param[in] Number of slots in the heap
+     */
+    explicit BlockTable(size_t num_slots)
+        : num_slots_{num_slots},
+          tags_{std::make_unique<uint8_t[]>(num_slots)},
+          next_{new uint32_t[num_slots]},
+          prev_{new uint32_t[num_slots]} {
+        assert(num_slots < NIL);
+    }
+
+    /**
+     * @brief Accessor for num_slots_
+     *
+     * @return Number of slots in the heap
+     */
+    size_t
+    size() const {
+        return num_slots_;
+    }
+
+    /**
+     * @brief Mark the slot as the start of a free block
+     *
+     * @param[in] Slot index
+     * @param[in] Block size level
+     */
+    void
+    set_free(uint32_t slot, unsigned level) {
+        tags_[slot] = FREE_BIT | encode(level);
+    }
+
+    /**
+     * @brief Mark the slot as the start of a proffered block
+     *
+     * @param[in] Slot index
+     * @param[in] Block size level
+     */
+    void
+    set_proffered(uint32_t slot, unsigned level) {
+        tags_[slot] = PROFFERED_BIT | encode(level);
+    }
+
+    /**
+     * @brief Mark the slot as the start of a proffered slab
+     *
+     * Slabs are proffered blocks which are further divided into objects.
+     * The tag's level holds the slab's object size level instead of the
+     * block size level.
+     *
+     * @param[in] Slot index
+     * @param[in] Object size level
+     */
+    void
+    set_slab(uint32_t slot, unsigned level) {
+        tags_[slot] = SLAB_BITS | encode(level);
+    }
+
+    /**
+     * @brief Clear the slot's tag
+     *
+     * @param[in] Slot index
+     */
+    void
+    clear(uint32_t slot) {
+        tags_[slot] = 0;
+    }
+
+    /**
+     * @brief Does the slot start a free block of the given level?
+     *
+     * @param[in] Slot index
+     * @param[in] Block size level
+     *
+     * @return A boolean denoting a matching free block
+     */
+    bool
+    is_free(uint32_t slot, unsigned level) const {
+        return slot < num_slots_ && tags_[slot] == (FREE_BIT | encode(level));
+    }
+
+    /**
+     * @brief Does the slot start a proffered block?
+     *
+     * @param[in] Slot index
+     *
+     * @return A boolean denoting a proffered block
+     */
+    bool
+    is_proffered(uint32_t slot) const {
+        return slot < num_slots_ && (tags_[slot] & PROFFERED_BIT);
+    }
+
+    /**
+     * @brief Does the slot start a proffered slab?
+     *
+     * @param[in] Slot index
+     *
+     * @return A boolean denoting a slab
+     */
+    bool
+    is_slab(uint32_t slot) const {
+        return slot < num_slots_ && (tags_[slot] & SLAB_BITS) == SLAB_BITS;
+    }
+
+    /**
+     * @brief Accessor for the level stored in the slot's tag
+     *
+     * @param[in] Slot index
+     *
+     * @return Block size level
+     */
+    unsigned
+    level(uint32_t slot) const {
+        return tags_[slot] & LEVEL_MASK;
+    }
+
+    /**
+     * @brief Accessor for the slot's next link
+     *
+     * @param[in] Slot index
+     *
+     * @return Reference to the link
+     */
+    uint32_t&
+    next(uint32_t slot) {
+        assert(slot < num_slots_);
+        return next_[slot];
+    }
+
+    /**
+     * @brief Accessor for the slot's previous link
+     *
+     * @param[in] Slot index
+     *
+     * @return Reference to the link
+     */
+    uint32_t&
+    prev(uint32_t slot) {
+        assert(slot < num_slots_);
+        return prev_[slot];
+    }
+
+  private:
+    /**
+     * @brief Encode level into the low tag bits
+     *
+     * @param[in] Block size level
+     *
+     * @return Encoded level
+     */
+    static uint8_t
+    encode(unsigned level) {
+        assert(level <= LEVEL_MASK);
+        return static_cast<uint8_t>(level);
+    }
+
+    /**
+     * @brief Tag bit denoting a free block
+     */
+    static constexpr uint8_t FREE_BIT {0x80};
+
+    /**
+     * @brief Tag bit denoting a proffered block
+     */
+    static constexpr uint8_t PROFFERED_BIT {0x40};
+
+    /**
+     * @brief Tag bits denoting a proffered slab
+     *
+     * A block is never free and proffered at once, so the combination
+     * is used to mark slabs.
+     */
+    static constexpr uint8_t SLAB_BITS {FREE_BIT | PROFFERED_BIT};
+
+    /**
+     * @brief Tag bits holding the block size level
+     */
+    static constexpr uint8_t LEVEL_MASK {0x3f};
+
+    /**
+     * @brief Number of slots in the heap
+     */
+    size_t num_slots_ {0};
+
+    /**
+     * @brief Per-slot tag
+     */
+    std::unique_ptr<uint8_t[]> tags_ {nullptr};
+
+    /**
+     * @brief Per-slot next link for free lists
+     */
+    std::unique_ptr<uint32_t[]> next_ {nullptr};
+
+    /**
+     * @brief Per-slot previous link for free lists
+     */
+    std::unique_ptr<uint32_t[]> prev_ {nullptr};
+};
+
+} // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_MEMORY_BLOCK_TABLE_HPP
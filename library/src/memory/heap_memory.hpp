@@ -23,8 +23,15 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_HEAP_MEMORY_HPP
 #define ROCSHMEM_LIBRARY_SRC_HEAP_MEMORY_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstdlib>
 #include <memory>
+#include <sstream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 /**
  * @file heap_memory.hpp
@@ -32,10 +39,33 @@
  * @brief Contains heap memory class
  *
  * @note The heap memory class owns the symmetric heap memory allocation
+ *
+ * When ROC_SHMEM_HEAP_LAZY is set and the allocator can reserve address
+ * space, the heap is reserved up front and backed by memory in chunks of
+ * ROC_SHMEM_HEAP_CHUNK_SIZE bytes (default 2 MiB) as blocks in them are
+ * handed out. Ranks which use a fraction of a worst-case sized heap then
+ * only pay for that fraction.
  */
 
 namespace rocshmem {
 
+/**
+ * @brief Detects allocators with reserve, commit and commit_granularity
+ */
+template <typename ALLOCATOR, typename = void>
+struct can_reserve : std::false_type {
+};
+
+template <typename ALLOCATOR>
+struct can_reserve<ALLOCATOR, std::void_t<
+    decltype(std::declval<ALLOCATOR&>().reserve(std::declval<void**>(),
+                                                size_t{})),
+    decltype(std::declval<ALLOCATOR&>().commit(std::declval<void*>(),
+                                               size_t{})),
+    decltype(std::declval<ALLOCATOR&>().commit_granularity())>>
+    : std::true_type {
+};
+
 template <typename ALLOCATOR>
 class HeapMemory {
   public:
@@ -55,8 +85,13 @@ class HeapMemory {
      */
     HeapMemory(size_t size)
     : size_{size} {
-        char* temp;
-        allocator_.allocate(reinterpret_cast<void**>(&temp), size_);
+        char* temp {nullptr};
+        if (getenv("ROC_SHMEM_HEAP_LAZY")) {
+            reserve(&temp);
+        }
+        if (!lazy_) {
+            allocator_.allocate(reinterpret_cast<void**>(&temp), size_);
+        }
         assert(temp);
         std::unique_ptr<char, Deleter> up {temp};
         up_ = std::move(up);
@@ -82,6 +117,65 @@ class HeapMemory {
         return size_;
     }
 
+    /**
+     * @brief Back a range of the heap with memory
+     *
+     * Called whenever a block is handed out. Chunks which are already
+     * backed are skipped, so the call is cheap after warm up. Does
+     * nothing unless the heap is lazy.
+     *
+     * @param[in] Raw pointer within the heap
+     * @param[in] Size in bytes of the range
+     *
+     * @return A boolean denoting the range is backed by memory
+     *
+     * @note Not thread-safe; callers serialize allocations.
+     */
+    bool
+    commit(char* ptr, size_t size) {
+        if constexpr (can_reserve<ALLOCATOR>::value) {
+            if (!lazy_ || !size) {
+                return true;
+            }
+            assert(ptr >= get_ptr() && ptr + size <= get_ptr() + size_);
+            size_t first = (ptr - get_ptr()) / chunk_size_;
+            size_t last = (ptr + size - 1 - get_ptr()) / chunk_size_;
+            for (auto chunk {first}; chunk <= last; chunk++) {
+                if (committed_[chunk]) {
+                    continue;
+                }
+                auto offset {chunk * chunk_size_};
+                auto length {std::min(chunk_size_, size_ - offset)};
+                if (!allocator_.commit(get_ptr() + offset, length)) {
+                    return false;
+                }
+                committed_[chunk] = true;
+                amount_committed_ += length;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Is the heap backed by memory on demand?
+     *
+     * @return bool
+     */
+    bool
+    is_lazy() {
+        return lazy_;
+    }
+
+    /**
+     * @brief Accessor for the amount of heap backed by memory
+     *
+     * @return Size in bytes
+     */
+    size_t
+    get_committed() {
+        return lazy_ ? amount_committed_ : size_;
+    }
+
     /**
      * @brief Returns is the heap is allocated with managed memory
      *
@@ -93,6 +187,37 @@ class HeapMemory {
     }
 
   private:
+    /**
+     * @brief Reserve the heap instead of allocating it
+     *
+     * Leaves lazy_ unset if the allocator cannot reserve.
+     *
+     * @param[out] Address of raw pointer to the reservation
+     */
+    void
+    reserve(char** ptr) {
+        if constexpr (can_reserve<ALLOCATOR>::value) {
+            if (auto chunk_cstr = getenv("ROC_SHMEM_HEAP_CHUNK_SIZE")) {
+                std::stringstream sstream(chunk_cstr);
+                sstream >> chunk_size_;
+            }
+            auto granularity {allocator_.commit_granularity()};
+            chunk_size_ = std::max(chunk_size_, granularity);
+            chunk_size_ = (chunk_size_ + granularity - 1) / granularity *
+                          granularity;
+
+            allocator_.reserve(reinterpret_cast<void**>(ptr), size_);
+            if (*ptr) {
+                lazy_ = true;
+                auto num_chunks {(size_ + chunk_size_ - 1) / chunk_size_};
+                committed_.assign(num_chunks, false);
+            }
+        } else {
+            fprintf(stderr, "Warning: ROC_SHMEM_HEAP_LAZY is not supported "
+                    "by this heap type, allocating the full heap\n");
+        }
+    }
+
     /**
      * @brief Template type member with allocate and deallocate methods.
      */
@@ -125,6 +250,26 @@ class HeapMemory {
      * @brief Size of heap memory.
      */
     size_t size_ {gibibyte_};
+
+    /**
+     * @brief Is the heap reserved and committed in chunks?
+     */
+    bool lazy_ {false};
+
+    /**
+     * @brief Size in bytes of each committed chunk
+     */
+    size_t chunk_size_ {size_t{1} << 21};
+
+    /**
+     * @brief One entry per chunk; true once the chunk is committed
+     */
+    std::vector<bool> committed_ {};
+
+    /**
+     * @brief Sum of committed chunk sizes
+     */
+    size_t amount_committed_ {0};
 };
 
 } // namespace rocshmem
@@ -24,6 +24,7 @@
 #define ROCSHMEM_LIBRARY_SRC_HEAP_TYPE_HPP
 
 #include "hip_allocator.hpp"
+#include "mmap_allocator.hpp"
 
 #include "config.h"
 
@@ -44,7 +45,7 @@ namespace rocshmem {
 #elif defined USE_COHERENT_HEAP || defined USE_CACHED_HEAP
     using HEAP_T = HeapMemory<HIPAllocator>;
 #elif defined USE_HOST_HEAP
-    using HEAP_T = HeapMemory<HostAllocator>;
+    using HEAP_T = HeapMemory<HostMmapAllocator>;
 #elif defined USE_HIP_HOST_HEAP
     using HEAP_T = HeapMemory<HIPHostAllocator>;
 #else
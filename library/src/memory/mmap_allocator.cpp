@@ -0,0 +1,265 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#include "mmap_allocator.hpp"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace rocshmem {
+
+namespace {
+
+/**
+ * @brief Mapping lengths keyed by base address
+ *
+ * HeapMemory frees through a separate allocator instance, so the length
+ * needed by munmap cannot live in the instance.
+ */
+std::mutex mappings_mutex;
+std::unordered_map<void*, size_t> mappings;
+
+size_t
+round_up(size_t size, size_t multiple) {
+    return (size + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+HostMmapAllocator::HostMmapAllocator() {
+    char* value {nullptr};
+    if ((value = getenv("ROC_SHMEM_HOST_HEAP_PAGES")) != nullptr) {
+        std::string pages {value};
+        if (pages == "thp") {
+            page_mode_ = PageMode::TRANSPARENT_HUGE;
+        } else if (pages == "2M") {
+            page_mode_ = PageMode::HUGETLB_2M;
+        } else if (pages == "1G") {
+            page_mode_ = PageMode::HUGETLB_1G;
+        }
+    }
+    if ((value = getenv("ROC_SHMEM_HOST_HEAP_NUMA_NODE")) != nullptr) {
+        numa_node_ = atoi(value);
+    }
+}
+
+HostMmapAllocator::HostMmapAllocator(PageMode page_mode,
+                                     int numa_node)
+    : page_mode_{page_mode}, numa_node_{numa_node} {
+}
+
+size_t
+HostMmapAllocator::page_size(PageMode page_mode) {
+    switch (page_mode) {
+        case PageMode::TRANSPARENT_HUGE:
+        case PageMode::HUGETLB_2M:
+            return size_t{1} << 21;
+        case PageMode::HUGETLB_1G:
+            return size_t{1} << 30;
+        default:
+            return sysconf(_SC_PAGESIZE);
+    }
+}
+
+void
+HostMmapAllocator::allocate(void** ptr, size_t size) {
+    place(ptr, size, PROT_READ | PROT_WRITE);
+}
+
+void
+HostMmapAllocator::reserve(void** ptr, size_t size) {
+    place(ptr, size, PROT_NONE);
+}
+
+bool
+HostMmapAllocator::commit(void* ptr, size_t size) {
+    assert(!(reinterpret_cast<uintptr_t>(ptr) % page_size(page_mode_)));
+    auto length {round_up(size, page_size(page_mode_))};
+    if (mprotect(ptr, length, PROT_READ | PROT_WRITE)) {
+        return false;
+    }
+
+    /*
+     * Fault the pages in now so the first device or network access does
+     * not take the fault. Older kernels lack the advice (EINVAL); first
+     * touch populates base and transparent huge pages there instead, but
+     * hugetlbfs pages cannot be checked without it.
+     */
+    bool hugetlb {page_mode_ == PageMode::HUGETLB_2M ||
+                  page_mode_ == PageMode::HUGETLB_1G};
+    int ret {0};
+#ifdef MADV_POPULATE_WRITE
+    ret = madvise(ptr, length, MADV_POPULATE_WRITE);
+#else
+    ret = -1;
+    errno = EINVAL;
+#endif
+    if (ret && (hugetlb || errno != EINVAL)) {
+        mprotect(ptr, length, PROT_NONE);
+        return false;
+    }
+    return true;
+}
+
+void
+HostMmapAllocator::deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    size_t length {0};
+    {
+        std::lock_guard<std::mutex> lock {mappings_mutex};
+        auto it {mappings.find(ptr)};
+        assert(it != mappings.end());
+        length = it->second;
+        mappings.erase(it);
+    }
+    munmap(ptr, length);
+}
+
+void
+HostMmapAllocator::place(void** ptr, size_t size, int prot) {
+    assert(ptr);
+    *ptr = nullptr;
+    if (!size) {
+        return;
+    }
+
+    auto length {round_up(size, page_size(page_mode_))};
+    auto base {map(length, prot)};
+    if (!base && page_mode_ != PageMode::DEFAULT &&
+        page_mode_ != PageMode::TRANSPARENT_HUGE) {
+        fprintf(stderr, "Warning: no %s huge pages available for the host "
+                "heap, falling back to transparent huge pages\n",
+                page_mode_ == PageMode::HUGETLB_2M ? "2M" : "1G");
+        page_mode_ = PageMode::TRANSPARENT_HUGE;
+        length = round_up(size, page_size(page_mode_));
+        base = map(length, prot);
+    }
+    if (!base) {
+        return;
+    }
+
+    if (page_mode_ == PageMode::TRANSPARENT_HUGE) {
+        madvise(base, length, MADV_HUGEPAGE);
+    }
+    if (numa_node_ != NO_NUMA_NODE) {
+        bind(base, length);
+    }
+
+    std::lock_guard<std::mutex> lock {mappings_mutex};
+    mappings[base] = length;
+    *ptr = base;
+}
+
+void*
+HostMmapAllocator::map(size_t length, int prot) {
+    int flags {MAP_PRIVATE | MAP_ANONYMOUS};
+    if (prot == PROT_NONE) {
+        flags |= MAP_NORESERVE;
+    }
+
+    if (page_mode_ == PageMode::HUGETLB_2M ||
+        page_mode_ == PageMode::HUGETLB_1G) {
+        flags |= MAP_HUGETLB;
+        flags |= page_mode_ == PageMode::HUGETLB_2M ? MAP_HUGE_2MB
+                                                    : MAP_HUGE_1GB;
+        auto base {mmap(nullptr, length, prot, flags, -1, 0)};
+        return base == MAP_FAILED ? nullptr : base;
+    }
+
+    /*
+     * Over-map by one page and trim both ends so the mapping starts on a
+     * huge page boundary; otherwise the first and last partial huge
+     * pages cannot be backed by transparent huge pages.
+     */
+    auto alignment {page_size(page_mode_)};
+    auto base_page {static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+    auto slack {alignment > base_page ? alignment : 0};
+
+    auto raw {mmap(nullptr, length + slack, prot, flags, -1, 0)};
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    if (!slack) {
+        return raw;
+    }
+
+    auto raw_c {reinterpret_cast<char*>(raw)};
+    auto value {reinterpret_cast<uintptr_t>(raw_c)};
+    auto base {reinterpret_cast<char*>(round_up(value, alignment))};
+    auto head {static_cast<size_t>(base - raw_c)};
+    if (head) {
+        munmap(raw_c, head);
+    }
+    if (slack - head) {
+        munmap(base + length, slack - head);
+    }
+    return base;
+}
+
+void
+HostMmapAllocator::bind(void* ptr, size_t length) {
+    constexpr size_t bits {sizeof(unsigned long) * CHAR_BIT};
+    auto node {static_cast<size_t>(numa_node_)};
+    std::vector<unsigned long> node_mask(node / bits + 1, 0);
+    node_mask[node / bits] |= 1UL << (node % bits);
+
+    /*
+     * The kernel reads one bit fewer than maxnode.
+     */
+    auto max_node {node_mask.size() * bits + 1};
+    auto ret {syscall(SYS_mbind, ptr, length, MPOL_BIND, node_mask.data(),
+                      max_node, 0)};
+    if (ret) {
+        fprintf(stderr, "Warning: unable to bind the host heap to NUMA "
+                "node %d: %s\n", numa_node_, strerror(errno));
+    }
+}
+
+}  // namespace rocshmem
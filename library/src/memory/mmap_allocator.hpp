@@ -0,0 +1,233 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_LIBRARY_SRC_MMAP_ALLOCATOR_HPP
+#define ROCSHMEM_LIBRARY_SRC_MMAP_ALLOCATOR_HPP
+
+/**
+ * @file mmap_allocator.hpp
+ *
+ * @brief Contains a page-size and NUMA aware allocator for host heaps
+ *
+ * A heap of a gibibyte or more backed by 4 KiB pages costs many TLB
+ * misses and a long memory registration at startup. This allocator maps
+ * the heap directly with mmap so it can be backed by huge pages and
+ * bound to a NUMA node before any page is touched.
+ *
+ * The default constructor reads its policy from the environment:
+ *
+ *   ROC_SHMEM_HOST_HEAP_PAGES  "thp" (transparent huge pages), "2M" or
+ *                              "1G" (hugetlbfs pages); unset or any
+ *                              other value uses the base page size
+ *   ROC_SHMEM_HOST_HEAP_NUMA_NODE  NUMA node to bind the heap to
+ *
+ * The allocator can also reserve the heap and commit it piecewise, which
+ * HeapMemory uses for lazily populated heaps.
+ */
+
+#include <cstddef>
+
+namespace rocshmem {
+
+class HostMmapAllocator
+{
+  public:
+    /**
+     * @brief Page backing policies
+     */
+    enum class PageMode {
+        DEFAULT,
+        TRANSPARENT_HUGE,
+        HUGETLB_2M,
+        HUGETLB_1G,
+    };
+
+    /**
+     * @brief Named constant for no NUMA binding
+     */
+    static constexpr int NO_NUMA_NODE {-1};
+
+    /**
+     * @brief Primary constructor
+     *
+     * Reads the page mode and NUMA node from the environment.
+     */
+    HostMmapAllocator();
+
+    /**
+     * @brief Secondary constructor
+     *
+     * @param[in] Page backing policy
+     * @param[in] NUMA node to bind to or NO_NUMA_NODE
+     */
+    HostMmapAllocator(PageMode page_mode,
+                      int numa_node);
+
+    /**
+     * @brief Allocates memory
+     *
+     * A hugetlbfs request which cannot be met (no reserved huge pages)
+     * falls back to transparent huge pages with a warning. A failed NUMA
+     * binding also only warns, since placement is a performance hint.
+     *
+     * @param[in, out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Size in bytes of memory allocation
+     */
+    void
+    allocate(void** ptr, size_t size);
+
+    /**
+     * @brief Reserves address space without backing memory
+     *
+     * The range follows the same page and NUMA policy as allocate but
+     * may not be accessed until it is committed.
+     *
+     * @param[in, out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Size in bytes of the reservation
+     */
+    void
+    reserve(void** ptr, size_t size);
+
+    /**
+     * @brief Backs part of a reservation with memory
+     *
+     * Reservations are mapped with MAP_NORESERVE, so a hugetlbfs pool
+     * which runs dry would only show up as SIGBUS on first touch. The
+     * pages are therefore faulted in here and a hugetlbfs range which
+     * cannot be populated is not committed.
+     *
+     * @param[in] Raw pointer aligned to commit_granularity
+     * @param[in] Size in bytes (rounded up to commit_granularity)
+     *
+     * @return A boolean denoting the range is backed by memory
+     */
+    bool
+    commit(void* ptr, size_t size);
+
+    /**
+     * @brief Smallest unit which commit can back
+     *
+     * @return Size in bytes
+     */
+    size_t
+    commit_granularity() const {
+        return page_size(page_mode_);
+    }
+
+    /**
+     * @brief Deallocates memory
+     *
+     * Works for memory mapped or reserved by any instance of this class.
+     *
+     * @param[in] Raw pointer returned by allocate
+     */
+    void
+    deallocate(void* ptr);
+
+    /**
+     * @brief Returns is memory is managed
+     *
+     * @return false; mapped host memory is never managed
+     */
+    bool
+    is_managed() {
+        return false;
+    }
+
+    /**
+     * @brief Accessor for the page backing policy
+     *
+     * Reflects any fallback taken by the last allocation.
+     *
+     * @return Page mode
+     */
+    PageMode
+    page_mode() const {
+        return page_mode_;
+    }
+
+    /**
+     * @brief Accessor for the NUMA node
+     *
+     * @return NUMA node or NO_NUMA_NODE
+     */
+    int
+    numa_node() const {
+        return numa_node_;
+    }
+
+    /**
+     * @brief Size and alignment of the pages used by a page mode
+     *
+     * @param[in] Page backing policy
+     *
+     * @return Size in bytes
+     */
+    static size_t
+    page_size(PageMode page_mode);
+
+  private:
+    /**
+     * @brief Map, advise, bind and record a heap-sized region
+     *
+     * @param[in, out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Size in bytes of the region
+     * @param[in] Initial page protection
+     */
+    void
+    place(void** ptr, size_t size, int prot);
+
+    /**
+     * @brief Map anonymous memory aligned to the page mode's page size
+     *
+     * @param[in] Length in bytes (a multiple of the page size)
+     * @param[in] Initial page protection
+     *
+     * @return Raw pointer or nullptr on failure
+     */
+    void*
+    map(size_t length, int prot);
+
+    /**
+     * @brief Bind a mapping to numa_node_
+     *
+     * @param[in] Raw pointer to the mapping
+     * @param[in] Length in bytes of the mapping
+     */
+    void
+    bind(void* ptr, size_t length);
+
+    /**
+     * @brief Page backing policy
+     */
+    PageMode page_mode_ {PageMode::DEFAULT};
+
+    /**
+     * @brief NUMA node to bind to or NO_NUMA_NODE
+     */
+    int numa_node_ {NO_NUMA_NODE};
+};
+
+} // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_MMAP_ALLOCATOR_HPP
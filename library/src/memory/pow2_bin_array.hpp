@@ -0,0 +1,534 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_LIBRARY_SRC_MEMORY_POW2_BIN_ARRAY_HPP
+#define ROCSHMEM_LIBRARY_SRC_MEMORY_POW2_BIN_ARRAY_HPP
+
+#include <array>
+#include <iostream>
+
+#include <cassert>
+#include <climits>
+#include <cstdint>
+
+#include "bin.hpp"
+#include "binner.hpp"
+#include "block_table.hpp"
+
+/**
+ * @file pow2_bin_array.hpp
+ *
+ * @brief Contains a flat container of power-of-two sized bins
+ *
+ * Each bin lives at the index given by the bit position of its size so
+ * lookups do not need to search. An occupancy bitmask records which bins
+ * hold elements; the first non-empty bin at or above a size is found
+ * with a single count-trailing-zeros instruction.
+ *
+ * The bins are intrusive free lists whose links live in a BlockTable.
+ * The same table records which blocks are proffered to the user so no
+ * per-allocation containers are needed.
+ */
+
+namespace rocshmem {
+
+/**
+ * @brief Helper to count trailing zeros of a bitmask
+ *
+ * @param[in] A non-zero input value
+ *
+ * @return __builtin_ctzll value
+ */
+inline unsigned
+ctz_fn(uint64_t v) {
+    assert(v);
+    return __builtin_ctzll(v);
+}
+
+template <typename T>
+class Pow2BinArray {
+  public:
+    /**
+     * @brief Number of bin levels (one per bit of a size_t)
+     */
+    static constexpr unsigned NUM_LEVELS {sizeof(size_t) * CHAR_BIT};
+
+    /**
+     * @brief Enable a bin
+     *
+     * @param[in] A power-of-two bin size
+     */
+    void
+    insert(size_t bin_size) {
+        enabled_ |= level_bit(level_of(bin_size));
+    }
+
+    /**
+     * @brief How many bins are enabled?
+     *
+     * @return The number of enabled bins
+     */
+    size_t
+    size() const {
+        return __builtin_popcountll(enabled_);
+    }
+
+    /**
+     * @brief Is a bin enabled?
+     *
+     * @param[in] A power-of-two bin size
+     *
+     * @return 1 if the bin is enabled and 0 otherwise
+     */
+    size_t
+    count(size_t bin_size) const {
+        return (enabled_ & level_bit(level_of(bin_size))) ? 1 : 0;
+    }
+
+    /**
+     * @brief Read-only accessor for a bin
+     *
+     * @param[in] A power-of-two bin size
+     *
+     * @return The bin holding elements of that size
+     *
+     * @note Mutations must go through put, get and remove so the
+     * occupancy bitmask and block table stay consistent.
+     */
+    const Bin&
+    operator[](size_t bin_size) const {
+        assert(count(bin_size));
+        return bins_[level_of(bin_size)];
+    }
+
+    /**
+     * @brief Attach the heap memory described by the bins
+     *
+     * Sizes the block table so that every smallest-bin-sized slot of the
+     * heap has an entry. Must be invoked after all bins are enabled and
+     * before any element is stored.
+     *
+     * @param[in] Aligned base address of the heap
+     * @param[in] Size of the aligned heap
+     */
+    void
+    attach_heap(char* heap_base, size_t heap_size) {
+        assert(enabled_);
+        heap_base_ = heap_base;
+        slot_shift_ = ctz_fn(enabled_);
+        auto slot_size {size_t{1} << slot_shift_};
+        table_ = BlockTable{(heap_size + slot_size - 1) >> slot_shift_};
+    }
+
+    /**
+     * @brief Smallest enabled bin size
+     *
+     * @return A bin size or 0 if no bins are enabled
+     */
+    size_t
+    smallest_bin_size() const {
+        if (!enabled_) {
+            return 0;
+        }
+        return size_t{1} << ctz_fn(enabled_);
+    }
+
+    /**
+     * @brief Largest enabled bin size
+     *
+     * @return A bin size or 0 if no bins are enabled
+     */
+    size_t
+    largest_bin_size() const {
+        if (!enabled_) {
+            return 0;
+        }
+        return size_t{1} << find_first_set_one(enabled_);
+    }
+
+    /**
+     * @brief Round a request up to the bin size which can hold it
+     *
+     * @param[in] Size in bytes of a request
+     *
+     * @return A bin size or 0 if the request is larger than every bin
+     */
+    size_t
+    round_up(size_t request_size) const {
+        assert(request_size);
+        auto smallest {smallest_bin_size()};
+        if (request_size <= smallest) {
+            return smallest;
+        }
+        auto level {find_first_set_one(request_size)};
+        if (request_size & (request_size - 1)) {
+            level++;
+        }
+        if (level >= NUM_LEVELS || !(enabled_ & level_bit(level))) {
+            return 0;
+        }
+        return size_t{1} << level;
+    }
+
+    /**
+     * @brief Find the first non-empty bin at or above a size
+     *
+     * @param[in] A power-of-two bin size
+     *
+     * @return A bin size or 0 if all candidate bins are empty
+     */
+    size_t
+    find_nonempty(size_t bin_size) const {
+        auto mask {occupied_ & ~(level_bit(level_of(bin_size)) - 1)};
+        if (!mask) {
+            return 0;
+        }
+        return size_t{1} << ctz_fn(mask);
+    }
+
+    /**
+     * @brief Is a bin empty?
+     *
+     * @param[in] A power-of-two bin size
+     *
+     * @return A boolean denoting bin emptiness
+     */
+    bool
+    empty(size_t bin_size) const {
+        return !(occupied_ & level_bit(level_of(bin_size)));
+    }
+
+    /**
+     * @brief Emplace an element in a bin
+     *
+     * @param[in] A power-of-two bin size
+     * @param[in] An element
+     */
+    void
+    put(size_t bin_size, T element) {
+        assert(count(bin_size));
+        assert(element.get_size() == bin_size);
+        auto level {level_of(bin_size)};
+        auto slot {slot_of(element.get_address())};
+        table_.set_free(slot, level);
+        bins_[level].put(&table_, slot);
+        occupied_ |= level_bit(level);
+    }
+
+    /**
+     * @brief Retrieve an element from a bin
+     *
+     * @param[in] A power-of-two bin size
+     *
+     * @return An element
+     */
+    T
+    get(size_t bin_size) {
+        auto level {level_of(bin_size)};
+        auto slot {bins_[level].get(&table_)};
+        table_.clear(slot);
+        update_occupancy(level);
+        return T{address_of(slot), bin_size};
+    }
+
+    /**
+     * @brief Remove a specific element from a bin
+     *
+     * @param[in] A power-of-two bin size
+     * @param[in] An element
+     *
+     * @return A boolean denoting whether the element was found
+     */
+    bool
+    remove(size_t bin_size, T element) {
+        auto level {level_of(bin_size)};
+        auto slot {slot_of(element.get_address())};
+        if (!table_.is_free(slot, level)) {
+            return false;
+        }
+        bins_[level].remove(&table_, slot);
+        table_.clear(slot);
+        update_occupancy(level);
+        return true;
+    }
+
+    /**
+     * @brief Is a specific element free within a bin?
+     *
+     * @param[in] A power-of-two bin size
+     * @param[in] An element
+     *
+     * @return A boolean denoting whether the element is in the bin
+     */
+    bool
+    contains(size_t bin_size, T element) const {
+        return table_.is_free(slot_of(element.get_address()),
+                              level_of(bin_size));
+    }
+
+    /**
+     * @brief Find the first element in a bin satisfying a predicate
+     *
+     * Walks the bin's free list; cost is linear in the bin's length.
+     *
+     * @param[in] A power-of-two bin size
+     * @param[in] A predicate taking a raw pointer
+     *
+     * @return An element or an empty element if none matched
+     */
+    template <typename PRED>
+    T
+    find_if(size_t bin_size, PRED pred) {
+        auto slot {bins_[level_of(bin_size)].front()};
+        while (slot != BlockTable::NIL) {
+            auto address {address_of(slot)};
+            if (pred(address)) {
+                return T{address, bin_size};
+            }
+            slot = table_.next(slot);
+        }
+        return T{};
+    }
+
+    /**
+     * @brief Record that an element was handed to the user
+     *
+     * @param[in] An element
+     */
+    void
+    mark_proffered(T element) {
+        auto slot {slot_of(element.get_address())};
+        table_.set_proffered(slot, level_of(element.get_size()));
+    }
+
+    /**
+     * @brief Retrieve and clear a proffered element
+     *
+     * @param[in] Raw pointer previously handed to the user
+     *
+     * @return An element
+     */
+    T
+    retrieve_proffered(char* ptr) {
+        auto record {find_proffered(ptr)};
+        table_.clear(slot_of(ptr));
+        return record;
+    }
+
+    /**
+     * @brief Look up a proffered element without clearing it
+     *
+     * @param[in] Raw pointer previously handed to the user
+     *
+     * @return An element
+     */
+    T
+    find_proffered(char* ptr) const {
+        auto slot {slot_of(ptr)};
+        assert(table_.is_proffered(slot));
+        return T{ptr, size_t{1} << table_.level(slot)};
+    }
+
+    /**
+     * @brief Does a plain proffered element start at an address?
+     *
+     * Slabs do not count. Safe to call concurrently with mutations of
+     * other slots.
+     *
+     * @param[in] Raw pointer which may be outside the heap or unaligned
+     *
+     * @return A boolean denoting a proffered element
+     */
+    bool
+    starts_proffered(char* ptr) const {
+        if (ptr < heap_base_) {
+            return false;
+        }
+        size_t offset = ptr - heap_base_;
+        if (offset & ((size_t{1} << slot_shift_) - 1)) {
+            return false;
+        }
+        auto slot {static_cast<uint32_t>(offset >> slot_shift_)};
+        return table_.is_proffered(slot) && !table_.is_slab(slot);
+    }
+
+    /**
+     * @brief Mark a proffered element as a slab of smaller objects
+     *
+     * @param[in] Raw pointer to the slab
+     * @param[in] Power-of-two object size
+     */
+    void
+    mark_slab(char* ptr, size_t object_size) {
+        auto slot {slot_of(ptr)};
+        assert(table_.is_proffered(slot));
+        table_.set_slab(slot, level_of(object_size));
+    }
+
+    /**
+     * @brief Turn a slab back into a plain proffered element
+     *
+     * @param[in] Raw pointer to the slab
+     * @param[in] Power-of-two slab size
+     */
+    void
+    unmark_slab(char* ptr, size_t slab_size) {
+        auto slot {slot_of(ptr)};
+        assert(table_.is_slab(slot));
+        table_.set_proffered(slot, level_of(slab_size));
+    }
+
+    /**
+     * @brief Object size of the slab starting at an address
+     *
+     * Safe to call concurrently with mutations of other slots.
+     *
+     * @param[in] Raw pointer which may be outside the heap
+     *
+     * @return Object size or 0 if no slab starts at the address
+     */
+    size_t
+    slab_object_size(char* ptr) const {
+        if (ptr < heap_base_) {
+            return 0;
+        }
+        auto slot {slot_of(ptr)};
+        if (!table_.is_slab(slot)) {
+            return 0;
+        }
+        return size_t{1} << table_.level(slot);
+    }
+
+    /**
+     * @brief Dump the enabled bins to the standard out
+     */
+    void
+    dump() const {
+        for (unsigned level {0}; level < NUM_LEVELS; level++) {
+            if (enabled_ & level_bit(level)) {
+                std::cout << "bin_size " << (size_t{1} << level)
+                          << " bin.size " << bins_[level].size() << std::endl;
+            }
+        }
+    }
+
+  private:
+    /**
+     * @brief Convert a power-of-two bin size into its level
+     *
+     * @param[in] A power-of-two bin size
+     *
+     * @return Index into bins_
+     */
+    static unsigned
+    level_of(size_t bin_size) {
+        assert(bin_size && !(bin_size & (bin_size - 1)));
+        return find_first_set_one(bin_size);
+    }
+
+    /**
+     * @brief Convert a heap address into its block table slot
+     *
+     * @param[in] Raw pointer within the heap
+     *
+     * @return Slot index
+     */
+    uint32_t
+    slot_of(char* address) const {
+        assert(address >= heap_base_);
+        size_t offset = address - heap_base_;
+        assert(!(offset & ((size_t{1} << slot_shift_) - 1)));
+        return offset >> slot_shift_;
+    }
+
+    /**
+     * @brief Convert a block table slot into its heap address
+     *
+     * @param[in] Slot index
+     *
+     * @return Raw pointer within the heap
+     */
+    char*
+    address_of(uint32_t slot) const {
+        return heap_base_ + (size_t{slot} << slot_shift_);
+    }
+
+    /**
+     * @brief Bitmask with only the level's bit set
+     *
+     * @param[in] Index into bins_
+     *
+     * @return A bitmask
+     */
+    static uint64_t
+    level_bit(unsigned level) {
+        assert(level < NUM_LEVELS);
+        return uint64_t{1} << level;
+    }
+
+    /**
+     * @brief Refresh occupancy bit after a bin shrinks
+     *
+     * @param[in] Index into bins_
+     */
+    void
+    update_occupancy(unsigned level) {
+        if (bins_[level].empty()) {
+            occupied_ &= ~level_bit(level);
+        }
+    }
+
+    /**
+     * @brief Bins indexed by the bit position of their size
+     */
+    std::array<Bin, NUM_LEVELS> bins_ {};
+
+    /**
+     * @brief Free list links and block tags indexed by slot
+     */
+    BlockTable table_ {};
+
+    /**
+     * @brief Aligned base address of the heap
+     */
+    char* heap_base_ {nullptr};
+
+    /**
+     * @brief Log2 of the slot size (the smallest bin size)
+     */
+    unsigned slot_shift_ {0};
+
+    /**
+     * @brief Bitmask of bins which are in use by the heap
+     */
+    uint64_t enabled_ {0};
+
+    /**
+     * @brief Bitmask of bins which currently hold elements
+     */
+    uint64_t occupied_ {0};
+};
+
+} // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_MEMORY_POW2_BIN_ARRAY_HPP
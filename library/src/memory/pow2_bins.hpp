@@ -24,11 +24,11 @@
 #define ROCSHMEM_LIBRARY_SRC_POW2_BINS_HPP
 
 #include <cassert>
-#include <map>
+#include <cstdint>
 
-#include "bin.hpp"
 #include "binner.hpp"
 #include "constants.hpp"
+#include "pow2_bin_array.hpp"
 #include "shmem_allocator_strategy.hpp"
 
 /**
@@ -44,24 +44,9 @@ namespace rocshmem {
 template <typename AR_T, typename HM_T>
 class Pow2Bins : public ShmemAllocatorStrategy {
     /**
-     * @brief Helper type for bins of address records
+     * @brief Helper type for size-indexed bins of address records
      */
-    using BIN_T = Bin<AR_T>;
-
-    /**
-     * @brief Helper type for size to bin maps
-     */
-    using BINS_T = std::map<size_t, BIN_T>;
-
-    /**
-     * @brief Helper type for BINS_T iterator
-     */
-    using BINS_IT_T = typename BINS_T::iterator;
-
-    /**
-     * @brief Helper type for raw pointers to address record maps
-     */
-    using PROFFERED_T = std::map<char*, AR_T>;
+    using BINS_T = Pow2BinArray<AR_T>;
 
   public:
     /**
@@ -81,6 +66,7 @@ class Pow2Bins : public ShmemAllocatorStrategy {
                   heap_mem->get_ptr(),
                   heap_mem->get_size()} {
         binner_.assign_heap_to_bins();
+        heap_base_ = binner_.get_heap().get_address();
     }
 
     /**
@@ -98,33 +84,23 @@ class Pow2Bins : public ShmemAllocatorStrategy {
             return;
         }
 
-        auto do_request_using = [&] (auto it) {
-            if (it != bins_.end()) {
-                AR_T record {retrieve_record_from_bin(it)};
-                /*
-                 * Record retrieval may have generated INVALID record.
-                 * If INVALID, do not mark record as proffered.
-                 * Also notice, input pointer "ptr" may have nullptr value.
-                 */
-                if (record.get_address()) {
-                    emplace_in_proffered(record);
-                }
-                *ptr = record.get_address();
-            }
-        };
-
         /*
-         * Try to find exact power-of-two matches.
+         * Round up to the nearest power-of-two size.
          */
-        do_request_using(bins_.find(request_size));
-        if (*ptr) {
+        auto bin_size {bins_.round_up(request_size)};
+        if (!bin_size) {
             return;
         }
 
+        AR_T record {retrieve_record_from_bin(bin_size)};
         /*
-         * Round up to the nearest power-of-two size.
+         * Record retrieval may have generated INVALID record.
+         * If INVALID, do not mark record as proffered.
          */
-        do_request_using(bins_.lower_bound(request_size));
+        if (record.get_address()) {
+            emplace_in_proffered(record);
+        }
+        *ptr = record.get_address();
     }
 
     /**
@@ -132,32 +108,221 @@ class Pow2Bins : public ShmemAllocatorStrategy {
      *
      * Released memory is tracked by bookkeeping structures within this class.
      *
-     * @param[in] Raw pointer to heap memory
+     * The released record is recombined with its buddy (the other half
+     * of the record it was split from) whenever the buddy is also free.
+     * Recombination continues upward through the bins so the heap does
+     * not fragment into small records over time.
      *
-     * @note We do not attempt to combine records together into larger
-     * even if it is possible to do so. This may eventually exhaust the
-     * number of records in the larger bins.
+     * @param[in] Raw pointer to heap memory
      */
     void
     free(char* ptr) override {
         auto record {retrieve_from_proffered(ptr)};
-        emplace_record_in_bin(record);
+        emplace_record_in_bin(coalesce_with_buddies(record));
     }
 
     /**
-     * @brief Sum of all proffered_ memory sizes
+     * @brief Allocates aligned memory from the heap
+     *
+     * The bins are searched from the requested size upward for a free
+     * block which contains a suitably aligned block boundary. The free
+     * block is split down around that boundary; the unused halves are
+     * returned to the bins. Memory is never over-allocated beyond the
+     * power-of-two rounding done by alloc.
+     *
+     * @param[in, out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Power-of-two alignment in bytes
+     * @param[in] Size in bytes of memory allocation
+     */
+    void
+    alloc_aligned(char** ptr, size_t alignment, size_t request_size) {
+        assert(ptr);
+        *ptr = nullptr;
+
+        if (!request_size || !alignment || (alignment & (alignment - 1))) {
+            return;
+        }
+
+        if (alignment <= ALIGNMENT) {
+            alloc(ptr, request_size);
+            return;
+        }
+
+        auto bin_size {bins_.round_up(request_size)};
+        if (!bin_size) {
+            return;
+        }
+
+        auto align_up = [alignment](char* address) {
+            auto value {reinterpret_cast<uintptr_t>(address)};
+            value = (value + alignment - 1) & ~(alignment - 1);
+            return reinterpret_cast<char*>(value);
+        };
+
+        auto largest_bin_size {bins_.largest_bin_size()};
+        for (auto size {bin_size}; size && size <= largest_bin_size; size <<= 1) {
+            auto holds_aligned_block = [&](char* address) {
+                auto aligned {align_up(address)};
+                size_t offset = aligned - heap_base_;
+                return !(offset % bin_size) &&
+                       aligned + bin_size <= address + size;
+            };
+
+            AR_T record {bins_.find_if(size, holds_aligned_block)};
+            if (!record.get_address()) {
+                continue;
+            }
+            bins_.remove(size, record);
+            auto aligned {align_up(record.get_address())};
+            record = split_down_to(record, bin_size, aligned);
+            emplace_in_proffered(record);
+            *ptr = record.get_address();
+            return;
+        }
+    }
+
+    /**
+     * @brief Resizes a proffered record without moving it
+     *
+     * Shrinking returns the unused upper halves to the bins. Growing
+     * succeeds only when the record is the lower half of each enclosing
+     * block up to the new size and every upper buddy along the way is
+     * free.
+     *
+     * @param[in] Raw pointer previously handed to the user
+     * @param[in] New size in bytes
+     *
+     * @return A boolean denoting whether the record now holds the size
+     */
+    bool
+    resize_in_place(char* ptr, size_t request_size) {
+        assert(ptr);
+        assert(request_size);
+
+        auto bin_size {bins_.round_up(request_size)};
+        if (!bin_size) {
+            return false;
+        }
+
+        auto record {bins_.find_proffered(ptr)};
+        if (bin_size == record.get_size()) {
+            return true;
+        }
+
+        if (bin_size < record.get_size()) {
+            record = retrieve_from_proffered(ptr);
+            emplace_in_proffered(split_down_to(record, bin_size, ptr));
+            return true;
+        }
+
+        for (AR_T r {record}; r.get_size() < bin_size;
+             r = AR_T{ptr, r.get_size() << 1}) {
+            auto buddy {buddy_of(r)};
+            if (buddy.get_address() < ptr ||
+                !bins_.contains(buddy.get_size(), buddy)) {
+                return false;
+            }
+        }
+
+        record = retrieve_from_proffered(ptr);
+        while (record.get_size() < bin_size) {
+            auto buddy {buddy_of(record)};
+            bins_.remove(buddy.get_size(), buddy);
+            record = record.combine(buddy);
+        }
+        emplace_in_proffered(record);
+
+        return true;
+    }
+
+    /**
+     * @brief Size of a proffered record
+     *
+     * @param[in] Raw pointer previously handed to the user
+     *
+     * @return Size in bytes of the record backing the pointer
+     */
+    size_t
+    proffered_size(char* ptr) {
+        return bins_.find_proffered(ptr).get_size();
+    }
+
+    /**
+     * @brief Block size which alloc would hand out for a request
+     *
+     * Depends only on the bins enabled at construction, so it is safe
+     * to call concurrently with alloc and free.
+     *
+     * @param[in] Size in bytes of memory allocation
+     *
+     * @return A bin size or 0 if the request cannot be served
+     */
+    size_t
+    block_size(size_t request_size) const {
+        return request_size ? bins_.round_up(request_size) : 0;
+    }
+
+    /**
+     * @brief Was a record starting at the address handed out by alloc?
+     *
+     * Records marked as slabs do not count.
+     *
+     * @param[in] Raw pointer which may be outside the heap or unaligned
+     *
+     * @return A boolean denoting a proffered record
+     */
+    bool
+    is_proffered(char* ptr) const {
+        return bins_.starts_proffered(ptr);
+    }
+
+    /**
+     * @brief Mark a proffered record as a slab of smaller objects
+     *
+     * @param[in] Raw pointer to the slab
+     * @param[in] Power-of-two object size
+     */
+    void
+    mark_slab(char* ptr, size_t object_size) {
+        bins_.mark_slab(ptr, object_size);
+    }
+
+    /**
+     * @brief Turn a slab back into a plain proffered record
+     *
+     * Must be called before the slab is freed.
+     *
+     * @param[in] Raw pointer to the slab
+     * @param[in] Power-of-two slab size
+     */
+    void
+    unmark_slab(char* ptr, size_t slab_size) {
+        bins_.unmark_slab(ptr, slab_size);
+    }
+
+    /**
+     * @brief Object size of the slab starting at an address
+     *
+     * Safe to call concurrently with alloc and free as long as the slab
+     * holds a live object.
+     *
+     * @param[in] Raw pointer which may be outside the heap
+     *
+     * @return Object size or 0 if no slab starts at the address
+     */
+    size_t
+    slab_object_size(char* ptr) const {
+        return bins_.slab_object_size(ptr);
+    }
+
+    /**
+     * @brief Sum of all proffered memory sizes
      *
      * @return memory size
      */
     size_t
     amount_proffered() {
-        size_t size {0};
-        auto sum_sizes = [&size](const auto& pair) {
-           auto [address, record] = pair;
-           size += record.get_size();
-        };
-        std::for_each(proffered_.begin(), proffered_.end(), sum_sizes);
-        return size;
+        return amount_proffered_;
     }
 
     /**
@@ -180,115 +345,123 @@ class Pow2Bins : public ShmemAllocatorStrategy {
      */
     void
     emplace_record_in_bin(AR_T record) {
-        auto record_size {record.get_size()};
-
-        auto bins_it = bins_.find(record_size);
-        assert(bins_it != bins_.end());
-
-        auto& [IGNORE_BIN_SIZE, bin] {*bins_it};
-        bin.put(record);
+        bins_.put(record.get_size(), record);
     }
 
     /**
-     * @brief Retrieve address record from bin within a BINS_IT_T
+     * @brief Build the buddy record for an address record
      *
-     * @param[in] a VALID FORWARD iterator containing a bin
+     * Records are split in halves starting from chunks which are aligned
+     * (relative to the heap base) to their own size. The buddy's offset
+     * therefore differs from the record's offset in exactly one bit.
      *
-     * @return An address record
+     * @param[in] An address record
      *
-     * @note May return an empty record indicating a retrieval failure.
-     * The failure must be resolved somewhere else within the allocation
-     * framework.
+     * @return The record's buddy
      */
     AR_T
-    retrieve_record_from_bin(BINS_IT_T it) {
-        try_to_ensure_bin_has_records(it);
-
-        auto& [IGNORE, bin] {*it};
-
-        if (bin.empty()) {
-            return AR_T{};
-        }
-
-        return bin.get();
+    buddy_of(AR_T record) {
+        auto size {record.get_size()};
+        size_t offset = record.get_address() - heap_base_;
+        assert(offset % size == 0);
+        return AR_T{heap_base_ + (offset ^ size), size};
     }
 
     /**
-     * @brief Attempt to accommodate a subsequent record request
+     * @brief Recursively combine a record with its free buddies
      *
-     * The bin under iterator may not (or may) contain records when
-     * this method is invoked. This method tries to make at least one
-     * record available.
+     * Each free buddy is removed from its bin and combined with the
+     * record. The process stops when the buddy is in use or when the
+     * largest bin size is reached.
      *
-     * @param[in] a VALID FORWARD iterator containing a bin
+     * @param[in] An address record
      *
-     * @note BINS_T container must be sorted in ascending bin size for
-     * delegate method "split_larger_bin"
+     * @return The largest record built from the input record
      */
-    void
-    try_to_ensure_bin_has_records(BINS_IT_T it) {
-        auto& [IGNORE, bin] {*it};
+    AR_T
+    coalesce_with_buddies(AR_T record) {
+        auto largest_bin_size {bins_.largest_bin_size()};
 
-        if (!bin.empty()) {
-            return;
+        while (record.get_size() < largest_bin_size) {
+            auto buddy {buddy_of(record)};
+            if (!bins_.remove(buddy.get_size(), buddy)) {
+                break;
+            }
+            record = record.combine(buddy);
         }
 
-        split_larger_bin(it);
+        return record;
     }
 
     /**
-     * @brief Split records in next largest bin
+     * @brief Retrieve address record from a bin
      *
-     * This method tries to create records within this bin by decomposing
-     * records in other bins (with larger bin sizes).
+     * If the bin is empty, the first non-empty larger bin is located
+     * through the occupancy bitmask. One of its records is split down
+     * to the requested size; the unused upper halves are stored in the
+     * intermediate bins.
      *
-     * This method may be called recursively if records are unavailable
-     * at each step until records are made available to the initial
-     * bin.
+     * @param[in] A power-of-two bin size
      *
-     * @param[in] a VALID FORWARD iterator containing a bin
+     * @return An address record
      *
-     * @note BINS_T container must be sorted in ascending bin size
+     * @note May return an empty record indicating a retrieval failure.
+     * The failure must be resolved somewhere else within the allocation
+     * framework.
      */
-    void
-    split_larger_bin(BINS_IT_T it) {
-        assert(it != bins_.end());
-
-        auto next {std::next(it)};
-        if (next == bins_.end()) {
-            return;
+    AR_T
+    retrieve_record_from_bin(size_t bin_size) {
+        auto nonempty_bin_size {bins_.find_nonempty(bin_size)};
+        if (!nonempty_bin_size) {
+            return AR_T{};
         }
 
-        auto& [IGNORE_NEXT, next_bin] {*next};
-        if (next_bin.empty()) {
-            split_larger_bin(next);
-        }
+        auto record {bins_.get(nonempty_bin_size)};
+        return split_down_to(record, bin_size, record.get_address());
+    }
 
-        if (next_bin.empty()) {
-            return;
+    /**
+     * @brief Split a record until it reaches a smaller bin size
+     *
+     * The half containing the kept address is retained at every step;
+     * the other halves are stored in the intermediate bins.
+     *
+     * @param[in] An address record which is not held in any bin
+     * @param[in] A power-of-two bin size
+     * @param[in] Address which the returned record must start at
+     *
+     * @return The record of the requested bin size starting at keep
+     */
+    AR_T
+    split_down_to(AR_T record, size_t bin_size, char* keep) {
+        while (record.get_size() > bin_size) {
+            auto [smaller, larger] {record.split()};
+            if (keep < larger.get_address()) {
+                emplace_record_in_bin(larger);
+                record = smaller;
+            } else {
+                emplace_record_in_bin(smaller);
+                record = larger;
+            }
         }
-
-        auto record {next_bin.get()};
-        auto [smaller, larger] {record.split()};
-
-        auto& [IGNORE, bin] {*it};
-        bin.put(larger);
-        bin.put(smaller);
+        assert(record.get_address() == keep);
+        return record;
     }
 
     /**
-     * @brief Store record in proffered_ data structure
+     * @brief Mark record as proffered within bins_
      *
      * @param[in] An address record
      */
     void
     emplace_in_proffered(AR_T record) {
         assert(record.get_address());
-        proffered_[record.get_address()] = record;
+        bins_.mark_proffered(record);
+        amount_proffered_ += record.get_size();
     }
 
     /**
-     * @brief Retrieve record from proffered_ data structure
+     * @brief Retrieve proffered record from bins_
      *
      * @param[in] raw memory pointer
      *
@@ -301,22 +474,19 @@ class Pow2Bins : public ShmemAllocatorStrategy {
     retrieve_from_proffered(char* ptr) {
         assert(ptr);
 
-        auto prof_it {proffered_.find(ptr)};
-        assert(prof_it != proffered_.end());
-
-        auto [IGNORE_RECORD_ADDR, record] {*prof_it};
-        proffered_.erase(prof_it);
+        auto record {bins_.retrieve_proffered(ptr)};
+        amount_proffered_ -= record.get_size();
 
         return record;
     }
 
     /**
-     * @brief Holds a SORTED set of bin objects
+     * @brief Holds a flat array of bin objects
      *
-     * The bin objects are sorted by ascending bin sizes. Each bin holds
-     * address records with matching sizes. The bin sizes increase by
-     * powers-of-two. There is a minimum bin size set by memory alignment
-     * constraints.
+     * The bin objects are indexed by the bit position of their bin size.
+     * Each bin holds address records with matching sizes. The bin sizes
+     * increase by powers-of-two. There is a minimum bin size set by
+     * memory alignment constraints.
      */
     BINS_T bins_ {};
 
@@ -331,13 +501,20 @@ class Pow2Bins : public ShmemAllocatorStrategy {
     Binner<AR_T, BINS_T> binner_ {};
 
     /**
-     * @brief Tracks all address records handed over to user.
+     * @brief Sum of sizes of all address records handed over to user.
+     *
+     * The sizes of the records themselves are tracked in the block
+     * table within bins_ since the user is not required to provide a
+     * size_t field back through the "free" interface.
+     */
+    size_t amount_proffered_ {0};
+
+    /**
+     * @brief Aligned base address of the heap memory
      *
-     * This member is required to track the sizes of memory allocations
-     * since the user is not required to provide a size_t field back
-     * through the "free" interface.
+     * Used to compute buddy addresses when records are freed.
      */
-    PROFFERED_T proffered_ {};
+    char* heap_base_ {nullptr};
 };
 
 } // namespace rocshmem
@@ -22,7 +22,11 @@
 
 #include "single_heap.hpp"
 
+#include <algorithm>
 #include <sstream>
+#include <vector>
+
+#include "util.hpp"
 
 namespace rocshmem {
 
@@ -39,7 +43,20 @@ SingleHeap::SingleHeap() {
 void
 SingleHeap::malloc(void** ptr,
                    size_t size) {
-    strat_.alloc(reinterpret_cast<char**>(ptr), size);
+    auto c_ptr {reinterpret_cast<char**>(ptr)};
+    auto block_size {cached_block_size(size)};
+    if (block_size) {
+        if (bins_.get(block_size, c_ptr) || refill(block_size, c_ptr)) {
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock {mutex_};
+        malloc_locked(c_ptr, size);
+    }
+    if (!*c_ptr && size && release_cached_blocks()) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        malloc_locked(c_ptr, size);
+    }
 }
 
 void
@@ -47,18 +64,81 @@ SingleHeap::free(void* ptr) {
     if (!ptr) {
         return;
     }
-    strat_.free(reinterpret_cast<char*>(ptr));
+    auto c_ptr {reinterpret_cast<char*>(ptr)};
+    auto size {usable_size(c_ptr)};
+    if (!SizeClassBins::caches(size)) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        free_locked(c_ptr);
+        return;
+    }
+
+    SizeClassBins::Batch evicted;
+    auto num_evicted {bins_.put(size, c_ptr, &evicted)};
+    if (!num_evicted) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock {mutex_};
+    for (size_t i {0}; i < num_evicted; i++) {
+        free_locked(evicted[i]);
+    }
 }
 
 void*
 SingleHeap::realloc(void* ptr, size_t size) {
-    return nullptr;
+    if (!ptr) {
+        void* new_ptr {nullptr};
+        malloc(&new_ptr, size);
+        return new_ptr;
+    }
+
+    if (!size) {
+        free(ptr);
+        return nullptr;
+    }
+
+    auto c_ptr {reinterpret_cast<char*>(ptr)};
+    bool in_slab {slab_.owns(c_ptr)};
+    auto old_size {usable_size(c_ptr)};
+
+    if (in_slab && size <= old_size) {
+        return ptr;
+    }
+    if (!in_slab && !SLAB_T::handles(size)) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        if (strat_.resize_in_place(c_ptr, size)) {
+            if (heap_mem_.commit(c_ptr, size)) {
+                return ptr;
+            }
+            strat_.resize_in_place(c_ptr, old_size);
+        }
+    }
+
+    void* new_ptr {nullptr};
+    malloc(&new_ptr, size);
+    if (!new_ptr) {
+        return nullptr;
+    }
+
+    auto copy_size {std::min(size, old_size)};
+    CHECK_HIP(hipMemcpy(new_ptr, ptr, copy_size, hipMemcpyDefault));
+    free(ptr);
+
+    return new_ptr;
 }
 
 void*
 SingleHeap::malign(size_t alignment,
                    size_t size) {
-    return nullptr;
+    char* ptr {nullptr};
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        malign_locked(&ptr, alignment, size);
+    }
+    if (!ptr && size && release_cached_blocks()) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        malign_locked(&ptr, alignment, size);
+    }
+    return ptr;
 }
 
 char*
@@ -73,7 +153,9 @@ SingleHeap::get_size() {
 
 size_t
 SingleHeap::get_used() {
-    return strat_.amount_proffered();
+    std::lock_guard<std::mutex> lock {mutex_};
+    return strat_.amount_proffered() - slab_.amount_unused() -
+           bins_.amount_cached();
 }
 
 size_t
@@ -81,4 +163,111 @@ SingleHeap::get_avail() {
     return get_size() - get_used();
 }
 
+size_t
+SingleHeap::get_committed() {
+    std::lock_guard<std::mutex> lock {mutex_};
+    return heap_mem_.get_committed();
+}
+
+size_t
+SingleHeap::get_slab_unused() {
+    std::lock_guard<std::mutex> lock {mutex_};
+    return slab_.amount_unused();
+}
+
+size_t
+SingleHeap::cached_block_size(size_t size) {
+    if (!size) {
+        return 0;
+    }
+    auto block_size {SLAB_T::handles(size) ? SLAB_T::class_size(size)
+                                           : strat_.block_size(size)};
+    return SizeClassBins::caches(block_size) ? block_size : 0;
+}
+
+bool
+SingleHeap::refill(size_t block_size,
+                   char** ptr) {
+    SizeClassBins::Batch blocks {};
+    size_t count {0};
+    {
+        std::lock_guard<std::mutex> lock {mutex_};
+        while (count < blocks.size()) {
+            malloc_locked(&blocks[count], block_size);
+            if (!blocks[count]) {
+                break;
+            }
+            count++;
+        }
+    }
+    *ptr = nullptr;
+    if (!count) {
+        return false;
+    }
+
+    *ptr = blocks[0];
+    auto num_binned {1 + bins_.fill(block_size, blocks.data() + 1, count - 1)};
+    if (num_binned < count) {
+        std::lock_guard<std::mutex> lock {mutex_};
+        for (auto i {num_binned}; i < count; i++) {
+            free_locked(blocks[i]);
+        }
+    }
+    return true;
+}
+
+size_t
+SingleHeap::usable_size(char* ptr) {
+    return slab_.owns(ptr) ? slab_.object_size(ptr)
+                           : strat_.proffered_size(ptr);
+}
+
+void
+SingleHeap::malloc_locked(char** ptr,
+                          size_t size) {
+    if (SLAB_T::handles(size)) {
+        slab_.alloc(ptr, size);
+    } else {
+        strat_.alloc(ptr, size);
+    }
+    if (*ptr && !heap_mem_.commit(*ptr, usable_size(*ptr))) {
+        free_locked(*ptr);
+        *ptr = nullptr;
+    }
+}
+
+void
+SingleHeap::malign_locked(char** ptr,
+                          size_t alignment,
+                          size_t size) {
+    strat_.alloc_aligned(ptr, alignment, size);
+    if (*ptr && !heap_mem_.commit(*ptr, usable_size(*ptr))) {
+        free_locked(*ptr);
+        *ptr = nullptr;
+    }
+}
+
+void
+SingleHeap::free_locked(char* ptr) {
+    if (slab_.owns(ptr)) {
+        slab_.free(ptr);
+        return;
+    }
+    strat_.free(ptr);
+}
+
+bool
+SingleHeap::release_cached_blocks() {
+    std::vector<char*> blocks;
+    bins_.drain(&blocks);
+    if (blocks.empty()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock {mutex_};
+    for (auto block : blocks) {
+        free_locked(block);
+    }
+    return true;
+}
+
 }  // namespace rocshmem
@@ -23,10 +23,14 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_SINGLE_HEAP_HPP
 #define ROCSHMEM_LIBRARY_SRC_SINGLE_HEAP_HPP
 
+#include <mutex>
+
 #include "address_record.hpp"
 #include "heap_memory.hpp"
 #include "heap_type.hpp"
 #include "pow2_bins.hpp"
+#include "slab_allocator.hpp"
+#include "size_class_bins.hpp"
 
 /**
  * @file single_heap.hpp
@@ -35,6 +39,19 @@
  *
  * The single heap implements local processing element allocations. The
  * symmetric heap delegates allocations to this class.
+ *
+ * Small requests are packed into slabs by size class; larger requests go
+ * directly to the power-of-two allocation strategy.
+ *
+ * All methods may be called concurrently from multiple host threads.
+ * Blocks up to SizeClassBins::MAX_LEVEL are served from bins with one
+ * lock per size; the slab allocator and allocation strategy sit behind
+ * another lock which is taken only to refill or flush a bin in a batch
+ * and for larger requests.
+ *
+ * Concurrent allocations are symmetric across processing elements only
+ * if every processing element issues them in the same order, as the
+ * OpenSHMEM collective rules already require.
  */
 
 namespace rocshmem {
@@ -50,6 +67,11 @@ class SingleHeap {
      */
     using STRAT_T = Pow2Bins<AR_T, HEAP_T>;
 
+    /**
+     * @brief Helper type for small allocation front end
+     */
+    using SLAB_T = SlabAllocator<STRAT_T>;
+
   public:
     /**
      * @brief Primary constructor
@@ -75,23 +97,28 @@ class SingleHeap {
     free(void* ptr);
 
     /**
-     * @brief
+     * @brief Resizes memory from the heap
+     *
+     * The allocation grows or shrinks in place when the power-of-two
+     * block structure allows it. Otherwise, a new allocation is made,
+     * the contents are copied and the old allocation is freed.
      *
-     * @param[in]
-     * @param[in]
+     * @param[in] Raw pointer to heap memory (may be nullptr)
+     * @param[in] New size in bytes of memory allocation
      *
-     * @return
+     * @return Raw pointer to resized memory or nullptr on failure
+     * (the original allocation is left untouched on failure)
      */
     void*
     realloc(void* ptr, size_t size);
 
     /**
-     * @brief
+     * @brief Allocates aligned memory from the heap
      *
-     * @param[in]
-     * @param[in]
+     * @param[in] Power-of-two alignment in bytes
+     * @param[in] Size in bytes of memory allocation
      *
-     * @return
+     * @return Raw pointer to heap memory or nullptr on failure
      */
     void*
     malign(size_t alignment,
@@ -116,6 +143,10 @@ class SingleHeap {
     /**
      * @brief Accessor for heap usage
      *
+     * Small objects count at their size class and larger allocations
+     * at their power-of-two block size. The difference from the bytes
+     * requested is the internal fragmentation.
+     *
      * @return Amount of used bytes in heap
      */
     size_t
@@ -129,6 +160,28 @@ class SingleHeap {
     size_t
     get_avail();
 
+    /**
+     * @brief Accessor for slab memory not handed out
+     *
+     * These bytes are reserved from the allocation strategy by slabs
+     * but are free for small allocations. They are included in
+     * get_avail.
+     *
+     * @return Amount of unused bytes in slabs
+     */
+    size_t
+    get_slab_unused();
+
+    /**
+     * @brief Accessor for the amount of heap backed by memory
+     *
+     * Equals get_size unless the heap is lazy.
+     *
+     * @return Size in bytes
+     */
+    size_t
+    get_committed();
+
     /**
      * @brief Returns is the heap is allocated with managed memory
      *
@@ -139,7 +192,103 @@ class SingleHeap {
         return heap_mem_.is_managed();
     }
 
+    /**
+     * @brief Returns is the heap is backed by memory on demand
+     *
+     * @return bool
+     */
+    bool
+    is_lazy() {
+        return heap_mem_.is_lazy();
+    }
+
   private:
+    /**
+     * @brief Block size to use for a request if it is binned
+     *
+     * @param[in] Size in bytes of memory allocation
+     *
+     * @return Binned block size or 0 if the request bypasses the bins
+     */
+    size_t
+    cached_block_size(size_t size);
+
+    /**
+     * @brief Size of the block or slab object backing a pointer
+     *
+     * Only reads block table tags which stay fixed while the pointer
+     * is live, so the heap lock is not needed.
+     *
+     * @param[in] Raw pointer to heap memory
+     *
+     * @return Size in bytes
+     */
+    size_t
+    usable_size(char* ptr);
+
+    /**
+     * @brief Allocate a batch of blocks for an empty bin
+     *
+     * The first block goes to the caller and the rest to the bin.
+     *
+     * @param[in] Binned block size in bytes
+     * @param[out] Address of raw pointer (&pointer_to_char)
+     *
+     * @return A boolean denoting a block was allocated
+     */
+    bool
+    refill(size_t block_size,
+           char** ptr);
+
+    /**
+     * @brief Allocates from the slabs or strategy
+     *
+     * @param[out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Size in bytes of memory allocation
+     *
+     * The blocks handed out are committed if the heap is lazy; a block
+     * which cannot be committed is freed and nullptr returned instead.
+     *
+     * @note Caller must hold mutex_
+     */
+    void
+    malloc_locked(char** ptr,
+                  size_t size);
+
+    /**
+     * @brief Allocates aligned memory from the strategy
+     *
+     * @param[out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Power-of-two alignment in bytes
+     * @param[in] Size in bytes of memory allocation
+     *
+     * @note Caller must hold mutex_
+     */
+    void
+    malign_locked(char** ptr,
+                  size_t alignment,
+                  size_t size);
+
+    /**
+     * @brief Frees to the slabs or strategy
+     *
+     * @param[in] Raw pointer to heap memory
+     *
+     * @note Caller must hold mutex_
+     */
+    void
+    free_locked(char* ptr);
+
+    /**
+     * @brief Return every binned block to the strategy
+     *
+     * Called when an allocation fails so the binned blocks can coalesce.
+     *
+     * @return A boolean denoting that blocks were released
+     */
+    bool
+    release_cached_blocks();
+
     /**
      * @brief Heap memory object
      */
@@ -149,6 +298,21 @@ class SingleHeap {
      * @brief Allocation strategy object
      */
     STRAT_T strat_ {&heap_mem_};
+
+    /**
+     * @brief Small allocation front end object
+     */
+    SLAB_T slab_ {&strat_};
+
+    /**
+     * @brief Bins of recently freed blocks
+     */
+    SizeClassBins bins_ {};
+
+    /**
+     * @brief Guards strat_ and slab_
+     */
+    std::mutex mutex_ {};
 };
 
 } // namespace rocshmem
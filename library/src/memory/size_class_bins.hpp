@@ -0,0 +1,270 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_LIBRARY_SRC_MEMORY_SIZE_CLASS_BINS_HPP
+#define ROCSHMEM_LIBRARY_SRC_MEMORY_SIZE_CLASS_BINS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <cassert>
+#include <cstdint>
+
+#include "pow2_bin_array.hpp"
+
+/**
+ * @file size_class_bins.hpp
+ *
+ * @brief Contains per size class bins of recently freed heap blocks
+ *
+ * Host threads which allocate and free scratch buffers in a loop would
+ * otherwise contend on the lock which guards the heap's allocation
+ * strategy. Freed blocks up to MAX_LEVEL are parked in the bin of their
+ * size and handed straight back on the next request of that size. Each
+ * bin has its own lock, so threads working on different sizes never
+ * contend and threads working on one size hold its lock only to push or
+ * pop a pointer. The strategy lock is only taken to refill an empty bin
+ * or to flush a full one, in batches of BATCH blocks.
+ *
+ * The bins are shared by all threads and every decision depends only on
+ * the sequence of calls, so all processing elements making the same
+ * calls get the same offsets.
+ */
+
+namespace rocshmem {
+
+class SizeClassBins {
+  public:
+    /**
+     * @brief Maximum number of blocks held per size
+     */
+    static constexpr unsigned DEPTH {32};
+
+    /**
+     * @brief Number of blocks moved to or from the strategy at once
+     */
+    static constexpr unsigned BATCH {DEPTH / 2};
+
+    /**
+     * @brief Smallest binned block size level (8 bytes)
+     */
+    static constexpr unsigned MIN_LEVEL {3};
+
+    /**
+     * @brief Largest binned block size level (64 KiB)
+     *
+     * Larger blocks are rarely churned fast enough to benefit and would
+     * let idle bins hoard a noticeable part of the heap.
+     */
+    static constexpr unsigned MAX_LEVEL {16};
+
+    /**
+     * @brief Holds the blocks of one refill or flush
+     */
+    using Batch = std::array<char*, BATCH>;
+
+    /**
+     * @brief Is a block size kept in the bins?
+     *
+     * @param[in] Size in bytes of a block
+     *
+     * @return A boolean denoting a binned size
+     */
+    static bool
+    caches(size_t block_size) {
+        if (!block_size || (block_size & (block_size - 1))) {
+            return false;
+        }
+        auto level {ctz_fn(block_size)};
+        return level >= MIN_LEVEL && level <= MAX_LEVEL;
+    }
+
+    /**
+     * @brief Take the most recently freed block of a size
+     *
+     * @param[in] Size in bytes of the block
+     * @param[out] Address of raw pointer (&pointer_to_char)
+     *
+     * @return A boolean denoting a hit
+     */
+    bool
+    get(size_t block_size, char** ptr) {
+        assert(caches(block_size));
+        auto& bin {bins_[level_of(block_size)]};
+        std::lock_guard<std::mutex> lock {bin.mutex};
+        if (!bin.count) {
+            return false;
+        }
+        *ptr = bin.blocks[--bin.count];
+        cached_.fetch_sub(block_size, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Park a freed block in the bin of its size
+     *
+     * When the bin is full, its oldest BATCH blocks are evicted so the
+     * caller can return those blocks to the allocation strategy under a
+     * single lock acquisition.
+     *
+     * @param[in] Size in bytes of the block
+     * @param[in] Raw pointer to the block
+     * @param[out] Blocks evicted from the bin
+     *
+     * @return Number of entries written to evicted
+     */
+    size_t
+    put(size_t block_size, char* ptr, Batch* evicted) {
+        assert(caches(block_size));
+        auto& bin {bins_[level_of(block_size)]};
+        std::lock_guard<std::mutex> lock {bin.mutex};
+
+        size_t num_evicted {0};
+        if (bin.count == DEPTH) {
+            num_evicted = evicted->size();
+            auto first {bin.blocks.begin()};
+            std::copy(first, first + num_evicted, evicted->begin());
+            std::copy(first + num_evicted, bin.blocks.end(), first);
+            bin.count -= num_evicted;
+        }
+        bin.blocks[bin.count++] = ptr;
+
+        cached_.fetch_add(block_size, std::memory_order_relaxed);
+        cached_.fetch_sub(num_evicted * block_size, std::memory_order_relaxed);
+        return num_evicted;
+    }
+
+    /**
+     * @brief Stock a bin with freshly allocated blocks
+     *
+     * The blocks are pushed so that they are handed out in the order
+     * given. Blocks which do not fit are left to the caller.
+     *
+     * @param[in] Size in bytes of the blocks
+     * @param[in] Blocks to stock
+     * @param[in] Number of blocks
+     *
+     * @return Number of leading blocks taken into the bin
+     */
+    size_t
+    fill(size_t block_size, char* const* blocks, size_t count) {
+        assert(caches(block_size));
+        auto& bin {bins_[level_of(block_size)]};
+        std::lock_guard<std::mutex> lock {bin.mutex};
+
+        auto num_taken {std::min<size_t>(count, DEPTH - bin.count)};
+        for (size_t i {num_taken}; i > 0; i--) {
+            bin.blocks[bin.count++] = blocks[i - 1];
+        }
+        cached_.fetch_add(num_taken * block_size, std::memory_order_relaxed);
+        return num_taken;
+    }
+
+    /**
+     * @brief Empty every bin
+     *
+     * Used when the allocation strategy runs out of memory; the binned
+     * blocks may coalesce into a block large enough for the request.
+     *
+     * @param[out] Vector which receives the binned blocks
+     */
+    void
+    drain(std::vector<char*>* blocks) {
+        for (unsigned i {0}; i < NUM_LEVELS; i++) {
+            auto& bin {bins_[i]};
+            std::lock_guard<std::mutex> lock {bin.mutex};
+            auto first {bin.blocks.begin()};
+            blocks->insert(blocks->end(), first, first + bin.count);
+            auto size {size_t{1} << (i + MIN_LEVEL)};
+            cached_.fetch_sub(bin.count * size, std::memory_order_relaxed);
+            bin.count = 0;
+        }
+    }
+
+    /**
+     * @brief Sum of all binned block sizes
+     *
+     * @return Size in bytes
+     */
+    size_t
+    amount_cached() const {
+        return cached_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    /**
+     * @brief Number of binned block size levels
+     */
+    static constexpr unsigned NUM_LEVELS {MAX_LEVEL - MIN_LEVEL + 1};
+
+    /**
+     * @brief Stack of freed blocks of one size and its lock
+     *
+     * Bins are aligned to a cache line so threads working on
+     * neighbouring sizes do not falsely share.
+     */
+    struct alignas(64) Bin {
+        /**
+         * @brief Guards blocks and count
+         */
+        std::mutex mutex {};
+
+        /**
+         * @brief Binned blocks; the most recently freed is on top
+         */
+        std::array<char*, DEPTH> blocks {};
+
+        /**
+         * @brief Number of valid entries in blocks
+         */
+        size_t count {0};
+    };
+
+    /**
+     * @brief Convert a binned block size into its level index
+     *
+     * @param[in] Size in bytes of a block
+     *
+     * @return Index into bins_
+     */
+    static unsigned
+    level_of(size_t block_size) {
+        return ctz_fn(block_size) - MIN_LEVEL;
+    }
+
+    /**
+     * @brief Bins indexed by level_of
+     */
+    std::array<Bin, NUM_LEVELS> bins_ {};
+
+    /**
+     * @brief Sum of all binned block sizes
+     */
+    std::atomic<size_t> cached_ {0};
+};
+
+} // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_MEMORY_SIZE_CLASS_BINS_HPP
@@ -0,0 +1,436 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_LIBRARY_SRC_MEMORY_SLAB_ALLOCATOR_HPP
+#define ROCSHMEM_LIBRARY_SRC_MEMORY_SLAB_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+#include <cassert>
+#include <cstdint>
+
+#include "pow2_bin_array.hpp"
+
+/**
+ * @file slab_allocator.hpp
+ *
+ * @brief Contains a size-class front end for small heap allocations
+ *
+ * Small requests (flags, counters, pSync arrays) would otherwise burn a
+ * full minimum-sized block each. The slab allocator carves fixed-size
+ * slabs out of the allocation strategy and packs objects of a single
+ * size class densely inside each slab.
+ *
+ * Every decision depends only on the sequence of calls, so all
+ * processing elements making the same calls get the same offsets.
+ */
+
+namespace rocshmem {
+
+template <typename STRAT_T>
+class SlabAllocator {
+  public:
+    /**
+     * @brief Size in bytes of each slab (also its alignment)
+     */
+    static constexpr size_t SLAB_SIZE {4096};
+
+    /**
+     * @brief Smallest size class in bytes
+     */
+    static constexpr size_t MIN_CLASS_SIZE {8};
+
+    /**
+     * @brief Largest size class in bytes
+     */
+    static constexpr size_t MAX_CLASS_SIZE {64};
+
+    /**
+     * @brief Required for default construction of other objects
+     *
+     * @note Not intended for direct usage.
+     */
+    SlabAllocator() = default;
+
+    /**
+     * @brief Primary constructor type
+     *
+     * @param[in] Raw pointer to the strategy which provides slabs
+     */
+    explicit SlabAllocator(STRAT_T* strat)
+        : strat_{strat} {
+    }
+
+    /**
+     * @brief Can the request be served by a size class?
+     *
+     * @param[in] Size in bytes of memory allocation
+     *
+     * @return A boolean denoting a small request
+     */
+    static bool
+    handles(size_t request_size) {
+        return request_size && request_size <= MAX_CLASS_SIZE;
+    }
+
+    /**
+     * @brief Size class which would serve a request
+     *
+     * @param[in] Size in bytes of memory allocation
+     *
+     * @return Object size in bytes
+     */
+    static size_t
+    class_size(size_t request_size) {
+        assert(handles(request_size));
+        return MIN_CLASS_SIZE << class_of(request_size);
+    }
+
+    /**
+     * @brief Base address of the slab which would contain a pointer
+     *
+     * @param[in] Raw pointer to heap memory
+     *
+     * @return Slab-aligned raw pointer
+     */
+    static char*
+    slab_base(char* ptr) {
+        auto value {reinterpret_cast<uintptr_t>(ptr)};
+        return reinterpret_cast<char*>(value & ~(SLAB_SIZE - 1));
+    }
+
+    /**
+     * @brief Allocates a small object
+     *
+     * @param[in, out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Size in bytes of memory allocation
+     */
+    void
+    alloc(char** ptr, size_t request_size) {
+        assert(ptr);
+        assert(handles(request_size));
+        *ptr = nullptr;
+
+        auto& size_class {classes_[class_of(request_size)]};
+        if (!size_class.partial) {
+            add_slab(&size_class);
+        }
+        auto slab {size_class.partial};
+        if (!slab) {
+            return;
+        }
+
+        *ptr = slab->take();
+        if (!slab->num_free) {
+            unlink(&size_class, slab);
+        }
+        unused_ -= slab->object_size;
+    }
+
+    /**
+     * @brief Does a pointer belong to a slab?
+     *
+     * Slabs are tagged in the strategy's block table, so this lookup
+     * does not touch the slab bookkeeping. It only reads tags which
+     * stay fixed while the pointer is live, so it is safe to call while
+     * another thread allocates or frees.
+     *
+     * @param[in] Raw pointer to heap memory
+     *
+     * @return A boolean denoting slab ownership
+     */
+    bool
+    owns(char* ptr) const {
+        return !strat_->is_proffered(ptr) &&
+               strat_->slab_object_size(slab_base(ptr));
+    }
+
+    /**
+     * @brief Size class of a slab object
+     *
+     * @param[in] Raw pointer owned by a slab
+     *
+     * @return Object size in bytes
+     */
+    size_t
+    object_size(char* ptr) const {
+        return strat_->slab_object_size(slab_base(ptr));
+    }
+
+    /**
+     * @brief Frees a small object
+     *
+     * Empty slabs are returned to the strategy unless they are the only
+     * slab left with free objects in their size class.
+     *
+     * @param[in] Raw pointer owned by a slab
+     */
+    void
+    free(char* ptr) {
+        auto it {slabs_.find(slab_base(ptr))};
+        assert(it != slabs_.end());
+        auto slab {&it->second};
+        auto& size_class {classes_[class_of(slab->object_size)]};
+
+        bool was_full {!slab->num_free};
+        slab->give(ptr);
+        unused_ += slab->object_size;
+
+        if (was_full) {
+            link(&size_class, slab);
+        }
+
+        bool empty {slab->num_free == slab->num_objects};
+        bool others_partial {size_class.partial != slab || slab->next};
+        if (empty && others_partial) {
+            unlink(&size_class, slab);
+            unused_ -= SLAB_SIZE;
+            strat_->unmark_slab(slab->base, SLAB_SIZE);
+            strat_->free(slab->base);
+            slabs_.erase(it);
+        }
+    }
+
+    /**
+     * @brief Bytes held by slabs which are not handed out
+     *
+     * @return Size in bytes
+     */
+    size_t
+    amount_unused() const {
+        return unused_;
+    }
+
+  private:
+    /**
+     * @brief Bookkeeping for one slab
+     */
+    struct Slab {
+        /**
+         * @brief Maximum number of objects in a slab
+         */
+        static constexpr size_t MAX_OBJECTS {SLAB_SIZE / MIN_CLASS_SIZE};
+
+        /**
+         * @brief Number of 64-bit words in free_mask
+         */
+        static constexpr size_t MASK_WORDS {MAX_OBJECTS / 64};
+
+        /**
+         * @brief Hand out the lowest free object
+         *
+         * @return Raw pointer to the object
+         */
+        char*
+        take() {
+            assert(num_free);
+            for (size_t w {0}; w < MASK_WORDS; w++) {
+                if (free_mask[w]) {
+                    auto bit {ctz_fn(free_mask[w])};
+                    free_mask[w] &= free_mask[w] - 1;
+                    num_free--;
+                    return base + (w * 64 + bit) * object_size;
+                }
+            }
+            assert(false);
+            return nullptr;
+        }
+
+        /**
+         * @brief Return an object to the slab
+         *
+         * @param[in] Raw pointer to the object
+         */
+        void
+        give(char* ptr) {
+            size_t index = (ptr - base) / object_size;
+            assert(base + index * object_size == ptr);
+            auto bit {uint64_t{1} << (index % 64)};
+            assert(!(free_mask[index / 64] & bit));
+            free_mask[index / 64] |= bit;
+            num_free++;
+        }
+
+        /**
+         * @brief Raw pointer to the start of the slab
+         */
+        char* base {nullptr};
+
+        /**
+         * @brief Size class of objects in this slab
+         */
+        size_t object_size {0};
+
+        /**
+         * @brief Number of objects which fit in this slab
+         */
+        size_t num_objects {0};
+
+        /**
+         * @brief Number of objects not handed out
+         */
+        size_t num_free {0};
+
+        /**
+         * @brief One bit per object; a set bit denotes a free object
+         */
+        std::array<uint64_t, MASK_WORDS> free_mask {};
+
+        /**
+         * @brief Links for the size class partial list
+         */
+        Slab* prev {nullptr};
+        Slab* next {nullptr};
+    };
+
+    /**
+     * @brief Per size class list of slabs with free objects
+     */
+    struct SizeClass {
+        /**
+         * @brief Head of the list of slabs with free objects
+         */
+        Slab* partial {nullptr};
+    };
+
+    /**
+     * @brief Number of size classes
+     */
+    static constexpr unsigned NUM_CLASSES {4};
+
+    static_assert((MIN_CLASS_SIZE << (NUM_CLASSES - 1)) == MAX_CLASS_SIZE);
+
+    /**
+     * @brief Map a request size onto its size class index
+     *
+     * @param[in] Size in bytes of memory allocation
+     *
+     * @return Index into classes_
+     */
+    static unsigned
+    class_of(size_t request_size) {
+        size_t class_size {MIN_CLASS_SIZE};
+        unsigned index {0};
+        while (class_size < request_size) {
+            class_size <<= 1;
+            index++;
+        }
+        assert(index < NUM_CLASSES);
+        return index;
+    }
+
+    /**
+     * @brief Carve a new slab for a size class from the strategy
+     *
+     * @param[in] Size class which needs free objects
+     */
+    void
+    add_slab(SizeClass* size_class) {
+        char* base {nullptr};
+        strat_->alloc_aligned(&base, SLAB_SIZE, SLAB_SIZE);
+        if (!base) {
+            return;
+        }
+
+        size_t object_size {MIN_CLASS_SIZE << (size_class - classes_.data())};
+        strat_->mark_slab(base, object_size);
+        auto& slab {slabs_[base]};
+        slab.base = base;
+        slab.object_size = object_size;
+        slab.num_objects = SLAB_SIZE / object_size;
+        slab.num_free = slab.num_objects;
+        for (size_t i {0}; i < slab.num_objects; i += 64) {
+            auto bits {std::min<size_t>(64, slab.num_objects - i)};
+            slab.free_mask[i / 64] = bits == 64 ? ~uint64_t{0}
+                                                : (uint64_t{1} << bits) - 1;
+        }
+        unused_ += SLAB_SIZE;
+
+        link(size_class, &slab);
+    }
+
+    /**
+     * @brief Push a slab onto the size class partial list
+     *
+     * @param[in] Size class owning the list
+     * @param[in] Slab with at least one free object
+     */
+    void
+    link(SizeClass* size_class, Slab* slab) {
+        slab->prev = nullptr;
+        slab->next = size_class->partial;
+        if (slab->next) {
+            slab->next->prev = slab;
+        }
+        size_class->partial = slab;
+    }
+
+    /**
+     * @brief Remove a slab from the size class partial list
+     *
+     * @param[in] Size class owning the list
+     * @param[in] Slab currently in the list
+     */
+    void
+    unlink(SizeClass* size_class, Slab* slab) {
+        if (slab->prev) {
+            slab->prev->next = slab->next;
+        } else {
+            size_class->partial = slab->next;
+        }
+        if (slab->next) {
+            slab->next->prev = slab->prev;
+        }
+        slab->prev = nullptr;
+        slab->next = nullptr;
+    }
+
+    /**
+     * @brief Strategy which provides slab memory
+     */
+    STRAT_T* strat_ {nullptr};
+
+    /**
+     * @brief Size classes indexed by class_of
+     */
+    std::array<SizeClass, NUM_CLASSES> classes_ {};
+
+    /**
+     * @brief Slab bookkeeping keyed by slab base address
+     *
+     * Nodes are only created when a slab is carved, so the small-object
+     * fast path does not allocate.
+     */
+    std::unordered_map<char*, Slab> slabs_ {};
+
+    /**
+     * @brief Bytes held by slabs which are not handed out
+     */
+    size_t unused_ {0};
+};
+
+} // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_MEMORY_SLAB_ALLOCATOR_HPP
@@ -75,6 +75,32 @@ class SymmetricHeap {
         single_heap_.free(ptr);
     }
 
+    /**
+     * @brief Resizes previously allocated network visible memory
+     *
+     * @param[in] Handle of previously allocated memory
+     * @param[in] New number of bytes requested
+     *
+     * @return Handle of resized memory or nullptr on failure
+     */
+    void*
+    realloc(void* ptr, size_t size) {
+        return single_heap_.realloc(ptr, size);
+    }
+
+    /**
+     * @brief Allocates aligned heap memory and returns ptr to caller
+     *
+     * @param[in] Power-of-two alignment in bytes
+     * @param[in] Number of bytes requested
+     *
+     * @return Handle of allocated memory or nullptr on failure
+     */
+    void*
+    malign(size_t alignment, size_t size) {
+        return single_heap_.malign(alignment, size);
+    }
+
     /**
      * @brief Accessor for local heap base
      *
@@ -134,6 +160,16 @@ class SymmetricHeap {
         return single_heap_.is_managed();
     }
 
+    /**
+     * @brief Returns is the heap is backed by memory on demand
+     *
+     * @return bool
+     */
+    bool
+    is_lazy() {
+        return single_heap_.is_lazy();
+    }
+
   private:
     /**
      * @brief Processing element's implementation of heap
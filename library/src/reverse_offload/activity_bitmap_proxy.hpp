@@ -0,0 +1,92 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_ACTIVITY_BITMAP_PROXY_HPP
+#define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_ACTIVITY_BITMAP_PROXY_HPP
+
+#include "ro_net_internal.hpp"
+#include "device_proxy.hpp"
+#include "thread_placement.hpp"
+
+namespace rocshmem {
+
+template <typename ALLOCATOR>
+class ActivityBitmapProxy {
+    static constexpr size_t MAX_NUM_BLOCKS {65536};
+    static constexpr size_t BITS_PER_WORD {64};
+    static constexpr size_t NUM_WORDS {MAX_NUM_BLOCKS / BITS_PER_WORD};
+
+    using ProxyT = DeviceProxy<ALLOCATOR, uint64_t, NUM_WORDS>;
+    using ProxySleepersT = DeviceProxy<ALLOCATOR, unsigned int>;
+
+  public:
+    /**
+     * @brief Initializes a bitmap with one bit per queue.
+     *
+     * A block sets the bit of its queue after it posts an element. The
+     * host clears the bit before it drains the queue, so the pollers only
+     * visit queues which may hold work.
+     */
+    ActivityBitmapProxy() {
+        size_t bitmap_bytes {sizeof(uint64_t) * NUM_WORDS};
+        memset(proxy_.get(), 0, bitmap_bytes);
+        *sleepers_proxy_.get() = 0;
+    }
+
+    /*
+     * @brief Provide access to the memory referenced by the proxy
+     */
+    __host__ __device__
+    uint64_t*
+    get() {
+        return proxy_.get();
+    }
+
+    /*
+     * @brief Provide access to the count of pollers blocked on the doorbell
+     */
+    __host__ __device__
+    unsigned int*
+    get_sleeping_pollers() {
+        return sleepers_proxy_.get();
+    }
+
+  private:
+    /**
+     * @brief Memory managed by the lifetime of this object
+     *
+     * The bitmap lives in host memory so the pollers can scan it without
+     * flushing the HDP.
+     */
+    ProxyT proxy_ {};
+
+    /**
+     * @brief Number of pollers blocked until a block rings the doorbell
+     */
+    ProxySleepersT sleepers_proxy_ {};
+};
+
+using ActivityBitmapProxyT = ActivityBitmapProxy<HIPHostLocalAllocator>;
+
+}  // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_ACTIVITY_BITMAP_PROXY_HPP
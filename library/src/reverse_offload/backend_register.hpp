@@ -23,6 +23,7 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_BACKEND_REGISTER_HPP
 #define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_BACKEND_REGISTER_HPP
 
+#include "progress_policy.hpp"
 #include "ro_net_internal.hpp"
 
 namespace rocshmem {
@@ -30,6 +31,10 @@ namespace rocshmem {
 struct BackendRegister {
     queue_element_t **queues {nullptr};
     queue_desc_t *queue_descs {nullptr};
+    uint64_t *activity_bitmap {nullptr};
+    unsigned int *sleeping_pollers {nullptr};
+    hsa_signal_t poller_signal {};
+    ProgressPolicy progress_policy {};
     ROStats *profiler {nullptr};
     int num_threads {-1};
     bool done_flag {false};
@@ -42,6 +47,8 @@ struct BackendRegister {
     WindowInfo **heap_window_info {nullptr};
     atomic_ret_t *atomic_ret {nullptr};
     bool gpu_queue {false};
+    bool put_batch {true};
+    bool put_inline {true};
     SymmetricHeap *heap_ptr {nullptr};
     int max_num_ctxs {-1};
     int *win_pool_alloc_bitmask {nullptr};
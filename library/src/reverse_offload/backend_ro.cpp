@@ -26,6 +26,8 @@
 #include <unistd.h>
 #include <smmintrin.h>
 #include <immintrin.h>
+#include <algorithm>
+#include <chrono>
 #include <thread>
 
 #include <roc_shmem.hpp>
@@ -37,6 +39,7 @@
 #include "mpi_transport.hpp"
 #include "wg_state.hpp"
 #include "atomic_return.hpp"
+#include "thread_placement.hpp"
 
 namespace rocshmem {
 
@@ -75,10 +78,41 @@ ROBackend::ROBackend(size_t num_wgs)
         bp->gpu_queue = false;
     }
 
+    if ((value = getenv("RO_NET_PUT_BATCH")) != nullptr) {
+        bp->put_batch = atoi(value);
+    }
+
+    if ((value = getenv("RO_NET_PUT_INLINE")) != nullptr) {
+        bp->put_inline = atoi(value);
+    }
+
     bp->queue_size = DEFAULT_QUEUE_SIZE;
     if ((value = getenv("RO_NET_QUEUE_SIZE")) != nullptr) {
-        bp->queue_size = atoi(value);
-        assert(bp->queue_size != 0);
+        // A full batch of puts is the longest command.
+        auto queue_size {atol(value)};
+        if (queue_size < RO_NET_MAX_CMD_SLOTS) {
+            fprintf(stderr, "Warning RO_NET_QUEUE_SIZE is below the "
+                            "minimum, using %d\n", RO_NET_MAX_CMD_SLOTS);
+            queue_size = RO_NET_MAX_CMD_SLOTS;
+        }
+        bp->queue_size = queue_size;
+    }
+
+    /*
+     * Pollers which sleep need the device to wake them, so only then do
+     * blocks check for sleepers and raise the doorbell signal.
+     */
+    bp->progress_policy = ProgressPolicy::from_env();
+    if (bp->progress_policy.mode == ProgressMode::SLEEP) {
+        bp->sleeping_pollers = activity_bitmap_proxy_.get_sleeping_pollers();
+        hsa_status_t status {hsa_signal_create(0,
+                                               0,
+                                               nullptr,
+                                               &bp->poller_signal)};
+        if (status != HSA_STATUS_SUCCESS) {
+            printf("Failed to create poller signal: 0x%x\n", status);
+            exit(-1);
+        }
     }
 
     /* Allocate pool of windows for RO_NET contexts */
@@ -133,6 +167,8 @@ ROBackend::ROBackend(size_t num_wgs)
 
     bp->queue_descs = queue_desc_proxy_.get();
 
+    bp->activity_bitmap = activity_bitmap_proxy_.get();
+
     default_context_proxy_ = std::move(DefaultContextProxyT(this));
 
     int num_threads {1};
@@ -140,19 +176,38 @@ ROBackend::ROBackend(size_t num_wgs)
         num_threads = atoi(value);
     }
 
-    if (num_threads > 0 &&
-        ((num_wg < num_threads) || ((num_wg % num_threads) != 0))) {
+    /*
+     * Queues are claimed dynamically, so any thread count works. Threads
+     * beyond one per queue would never find an unclaimed queue.
+     */
+    if (num_threads < 0) {
         exit(-static_cast<int>(Status::ROC_SHMEM_INVALID_ARGUMENTS));
     }
+    num_threads = std::min(num_threads, static_cast<int>(num_wg));
 
     bp->num_threads = num_threads;
 
+    std::vector<std::atomic<bool>> queue_claimed(num_wg);
+    queue_claimed_.swap(queue_claimed);
+    batch_progress_.assign(num_wg, 0);
+    read_idx_.resize(num_wg);
+    for (size_t i {0}; i < num_wg; i++) {
+        read_idx_[i] = bp->queue_descs[i].read_idx;
+    }
+
+    for (int i {0}; i < num_threads; i++) {
+        queue_element_proxies_.push_back(
+            std::make_unique<QueueElementProxyT>());
+    }
+
     // Spawn threads to service the queues.
+    auto placement {ThreadPlacement::from_env("RO_NET_POLLER_CPUS")};
     for (size_t i {0}; i < num_threads; i++) {
         worker_threads.emplace_back(&ROBackend::ro_net_poll,
                                     this,
                                     i,
                                     num_threads);
+        placement.apply(worker_threads.back(), i);
     }
 
     *done_init = 1;
@@ -288,6 +343,14 @@ ROBackend::ro_net_free_runtime() {
      */
     bp->done_flag = 1;
 
+    /*
+     * Wake the worker threads and the progress threads if they sleep.
+     */
+    if (bp->sleeping_pollers) {
+        hsa_signal_add_screlease(bp->poller_signal, 1);
+    }
+    transport_.wakeProgressThreads();
+
     /*
      * Tear down the worker threads.
      */
@@ -295,6 +358,10 @@ ROBackend::ro_net_free_runtime() {
        t.join();
     }
 
+    if (bp->sleeping_pollers) {
+        hsa_signal_destroy(bp->poller_signal);
+    }
+
     /*
      * Tear down the transport object.
      */
@@ -324,80 +391,196 @@ ROBackend::ro_net_free_runtime() {
 }
 
 bool
-ROBackend::ro_net_process_queue(int queue_idx) {
+ROBackend::ro_net_process_queue(int queue_idx,
+                                queue_element_t *element_cache) {
     /*
      * Determine which indices to access in the queue.
      */
     auto *bp {backend_proxy.get()};
-    queue_desc_t *queue_desc {&bp->queue_descs[queue_idx]};
-    DPRINTF("Queue Desc read_idx %zu\n", queue_desc->read_idx);
-    uint64_t read_slot {queue_desc->read_idx % bp->queue_size};
+    DPRINTF("Queue read_idx %zu\n", read_idx_[queue_idx]);
+    uint64_t read_idx {read_idx_[queue_idx]};
+    uint64_t read_slot {read_idx % bp->queue_size};
+    queue_element_t *queue {bp->queues[queue_idx]};
 
     /*
-     * Check if next element from the device is ready.
+     * Check if next element from the device is ready. Its header carries
+     * the sequence number of the read index once the device is done
+     * writing it.
      */
-    const queue_element_t *next_element {nullptr};
-    if (bp->gpu_queue) {
-        /*
-         * Flush HDP read cache so we can see updates to the GPU Queue
-         * descriptor.
-         */
-        bp->hdp_policy->hdp_flush();
+    if (queue[read_slot].seq != queue_slot_seq(read_idx)) {
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    const queue_element_t *next_element {&queue[read_slot]};
+    const queue_element_ext_t *next_ext {nullptr};
+    uint64_t num_ext {next_element->num_ext};
+    bool inline_put {is_inline_put(next_element->type)};
+    if (num_ext && !inline_put) {
+        next_ext = reinterpret_cast<const queue_element_ext_t*>(
+            &queue[(read_idx + 1) % bp->queue_size]);
+    }
 
+    if (bp->gpu_queue) {
         /*
-         * Copy the queue element from device memory to the host memory cache.
+         * The caller has flushed the HDP read cache so we can see updates
+         * to the GPU Queue descriptor.
+         *
+         * Copy the command from device memory to the host memory cache.
          */
-        ::memcpy((void*)queue_element_cache_,
-                 &bp->queues[queue_idx][read_slot],
+        ::memcpy((void*)element_cache,
+                 next_element,
                  sizeof(queue_element_t));
+        next_element = element_cache;
+        if (next_ext) {
+            auto *ext_cache {
+                reinterpret_cast<queue_element_ext_t*>(element_cache + 1)};
+            ::memcpy((void*)ext_cache,
+                     next_ext,
+                     sizeof(queue_element_ext_t));
+            next_ext = ext_cache;
+        }
+    }
 
-        /*
-         * Set our local variable to the next element.
-         */
-        next_element = queue_element_cache_;
-    } else {
-        /*
-         * Set our local variable to the next element.
-         */
-        next_element = &bp->queues[queue_idx][read_slot];
+    /*
+     * Gather the payload of an inline put from its slots, which may wrap
+     * around the end of the queue, behind the header in the cache.
+     */
+    const char *payload {nullptr};
+    if (inline_put) {
+        auto *staging {reinterpret_cast<char*>(element_cache + 1)};
+        size_t size {static_cast<size_t>(next_element->size)};
+        for (uint64_t i {0}; i < num_ext; i++) {
+            auto *slot {reinterpret_cast<const queue_element_payload_t*>(
+                &queue[(read_idx + 1 + i) % bp->queue_size])};
+            auto offset {i * RO_NET_INLINE_BYTES_PER_SLOT};
+            auto bytes {std::min<size_t>(size - offset,
+                                         RO_NET_INLINE_BYTES_PER_SLOT)};
+            ::memcpy(staging + offset, slot->data, bytes);
+        }
+        payload = staging;
     }
 
     /*
-     * By default, assume that no valid queue element exists. If a valid
-     * queue element is found, we'll flip this return value to true.
+     * Pass a copy of the command to the transport. If its ring is full,
+     * leave the command in the device queue and keep the queue marked
+     * active so it is retried later.
      */
-    bool valid {false};
+    bool inserted {next_element->type == RO_NET_PUT_BATCH ?
+                   ro_net_unpack_batch(queue_idx, next_element, read_idx) :
+                   transport_.insertRequest(next_element,
+                                            next_ext,
+                                            payload,
+                                            queue_idx)};
+    if (!inserted) {
+        mark_queue_active(queue_idx);
+        return false;
+    }
+
+    DPRINTF("Rank %d Processing read_slot %lu of queue %d \n",
+            my_pe, read_slot, queue_idx);
 
     /*
-     * Search for a single valid element and process that element through
-     * the transport if one is found.
+     * Update the CPU's local read index. The device sees it when the drain
+     * ends. The slots need no clearing; their sequence numbers are stale
+     * once the device wraps around.
      */
-    if (next_element->valid) {
-        valid = true;
+    read_idx_[queue_idx] = read_idx + 1 + num_ext;
 
-        DPRINTF("Rank %d Processing read_slot %lu of queue %d \n",
-                my_pe, read_slot, queue_idx);
+    return true;
+}
 
-        /*
-         * Pass the queue element to the transport.
-         * TODO: Who is responsible for freeing this memory?
-         */
-        transport_.insertRequest(new queue_element_t(*next_element),
-                                 queue_idx);
+bool
+ROBackend::ro_net_unpack_batch(int queue_idx,
+                               const queue_element_t *header,
+                               uint64_t read_idx) {
+    auto *bp {backend_proxy.get()};
+    queue_element_t *queue {bp->queues[queue_idx]};
 
-        /*
-         * Toggle the queue flag back to invalid since the request was
-         * just processed.
-         */
-        bp->queues[queue_idx][read_slot].valid = 0;
+    /*
+     * Each batched put goes to the transport as its own non-blocking put,
+     * so the transport's grouping and completion tracking apply as usual.
+     */
+    queue_element_t element {};
+    element.type = RO_NET_PUT_NBI;
+    element.PE = header->PE;
+    element.threadId = header->threadId;
+
+    auto &progress {batch_progress_[queue_idx]};
+    for (; progress < header->size; progress++) {
+        auto slot {read_idx + 1 + progress / RO_NET_BATCH_OPS_PER_SLOT};
+        auto op {progress % RO_NET_BATCH_OPS_PER_SLOT};
+        const auto *ext {reinterpret_cast<const queue_element_batch_t*>(
+            &queue[slot % bp->queue_size])};
+        element.dst = ext->dst[op];
+        element.src = ext->src[op];
+        element.size = ext->size[op];
+        if (!transport_.insertRequest(&element,
+                                      nullptr,
+                                      nullptr,
+                                      queue_idx)) {
+            return false;
+        }
+    }
+    progress = 0;
+    return true;
+}
 
-        /*
-         * Update the CPU's local read index.
-         */
-        queue_desc->read_idx++;
+bool
+ROBackend::claim_queue(size_t queue_idx) {
+    /*
+     * Test before exchanging so pollers passing over a busy queue do not
+     * bounce its cache line.
+     */
+    auto &claimed {queue_claimed_[queue_idx]};
+    return !claimed.load(std::memory_order_relaxed) &&
+           !claimed.exchange(true, std::memory_order_acquire);
+}
+
+void
+ROBackend::release_queue(size_t queue_idx) {
+    queue_claimed_[queue_idx].store(false, std::memory_order_release);
+}
+
+void
+ROBackend::mark_queue_active(size_t queue_idx) {
+    auto *bp {backend_proxy.get()};
+    __atomic_fetch_or(&bp->activity_bitmap[queue_idx / 64],
+                      uint64_t{1} << (queue_idx % 64),
+                      __ATOMIC_RELEASE);
+}
+
+void
+ROBackend::wait_for_post() {
+    auto *bp {backend_proxy.get()};
+    size_t num_words {(num_wg + 63) / 64};
+
+    /*
+     * Count ourselves as sleeping before the last look at the bitmap. A
+     * block which posts after that look sees the count and raises the
+     * signal past the value read here.
+     */
+    auto ticket {hsa_signal_load_scacquire(bp->poller_signal)};
+    __atomic_fetch_add(bp->sleeping_pollers, 1, __ATOMIC_SEQ_CST);
+
+    bool idle {!bp->done_flag};
+    for (size_t word {0}; idle && word < num_words; word++) {
+        if (__atomic_load_n(&bp->activity_bitmap[word], __ATOMIC_SEQ_CST)) {
+            idle = false;
+        }
+    }
+
+    if (idle) {
+        auto timeout {std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          bp->progress_policy.max_sleep)};
+        hsa_signal_wait_scacquire(bp->poller_signal,
+                                  HSA_SIGNAL_CONDITION_NE,
+                                  ticket,
+                                  timeout.count(),
+                                  HSA_WAIT_STATE_BLOCKED);
     }
 
-    return valid;
+    __atomic_fetch_sub(bp->sleeping_pollers, 1, __ATOMIC_SEQ_CST);
 }
 
 // TODO: change these int parameters into size_t
@@ -412,31 +595,100 @@ ROBackend::ro_net_poll(int thread_id, int num_threads) {
 
     auto *bp {backend_proxy.get()};
 
+    auto *element_cache {queue_element_proxies_[thread_id]->get()};
+
+    auto *activity_bitmap {bp->activity_bitmap};
+    size_t num_words {(num_wg + 63) / 64};
+
+    /*
+     * Stagger the starting bitmap word so the pollers spread out over the
+     * queues instead of contending for the same ones.
+     */
+    size_t start {static_cast<size_t>(thread_id) * num_words / num_threads};
+
+    IdleBackoff backoff {bp->progress_policy.mode};
+
     /*
      * Continue until the runtime is torn down.
      */
     while (!bp->done_flag) {
-        /*
-         * Each worker thread is responsible for evaluating a queue index
-         * at a time.
-         */
-        size_t tid = static_cast<size_t>(thread_id);
-        for (size_t i {tid}; i < num_wg; i += num_threads) {
-            /*
-             * Drain up to 64 requests from this queue if they are ready.
-             */
-            int req_count {0};
+        bool found_work {false};
+
+        for (size_t n {0}; n < num_words; n++) {
+            size_t word {start + n < num_words ? start + n
+                                               : start + n - num_words};
 
             /*
-             * This variable will evaluate to "True" as long as valid queue
-             * entries are found and processed. The loop ends when this
-             * evaluates to "False" or we evaluate 64 entries.
+             * Only queues whose bit is set may hold work.
              */
-            bool processed_req {false};
-            do {
-                processed_req = ro_net_process_queue(i);
-                req_count++;
-            } while (processed_req && (req_count < 64));
+            uint64_t active {__atomic_load_n(&activity_bitmap[word],
+                                             __ATOMIC_ACQUIRE)};
+            bool flushed {false};
+
+            while (active) {
+                int bit {__builtin_ctzll(active)};
+                active &= active - 1;
+                size_t i {word * 64 + bit};
+
+                /*
+                 * Skip queues which another worker is draining.
+                 */
+                if (!claim_queue(i)) {
+                    continue;
+                }
+
+                /*
+                 * Clear the bit before draining so an element posted during
+                 * the drain sets it again.
+                 */
+                __atomic_fetch_and(&activity_bitmap[word],
+                                   ~(uint64_t{1} << bit),
+                                   __ATOMIC_ACQ_REL);
+
+                /*
+                 * Flush HDP read cache once for all queues of this word so
+                 * we can see updates to the GPU Queue descriptors.
+                 */
+                if (bp->gpu_queue && !flushed) {
+                    bp->hdp_policy->hdp_flush();
+                    flushed = true;
+                }
+
+                /*
+                 * Drain up to MAX_DRAIN_PER_CLAIM requests from this queue
+                 * if they are ready.
+                 */
+                int req_count {0};
+                while (req_count < MAX_DRAIN_PER_CLAIM &&
+                       ro_net_process_queue(i, element_cache)) {
+                    req_count++;
+                }
+
+                /*
+                 * The queue may hold more elements; come back next pass.
+                 */
+                if (req_count == MAX_DRAIN_PER_CLAIM) {
+                    mark_queue_active(i);
+                }
+
+                /*
+                 * Return the drained slots to the device in one write.
+                 */
+                if (req_count) {
+                    __atomic_store_n(&bp->queue_descs[i].read_idx,
+                                     read_idx_[i],
+                                     __ATOMIC_RELEASE);
+                    found_work = true;
+                }
+
+                release_queue(i);
+            }
+        }
+
+        if (found_work) {
+            backoff.reset();
+        } else if (backoff.idle()) {
+            wait_for_post();
         }
     }
 }
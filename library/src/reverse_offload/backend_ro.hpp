@@ -23,8 +23,14 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_BACKEND_RO_HPP
 #define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_BACKEND_RO_HPP
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include "backend_bc.hpp"
 
+#include "activity_bitmap_proxy.hpp"
 #include "backend_proxy.hpp"
 #include "barrier_proxy.hpp"
 #include "context_pool_proxy.hpp"
@@ -127,12 +133,35 @@ class ROBackend : public Backend {
      * @brief Try to process one element from the queue.
      *
      * @param[in] queue_idx Index to access the queue_desc and queues fields.
+     * @param[in] element_cache Host buffer owned by the calling poller
+     * which receives a copy of a command's header and extension slots.
      *
      * @return Boolean value with "True" indicating that one element was
      * process and "False" indicating that no valid queue element was
      * found.
+     *
+     * @note The caller must hold the claim on queue_idx and, for queues
+     * in GPU memory, have flushed the HDP read cache.
      */
-    bool ro_net_process_queue(int queue_idx);
+    bool ro_net_process_queue(int queue_idx,
+                              queue_element_t *element_cache);
+
+    /**
+     * @brief Hand the puts of an RO_NET_PUT_BATCH command to the transport.
+     *
+     * @param[in] queue_idx Index of the queue holding the command.
+     * @param[in] header Header slot of the command.
+     * @param[in] read_idx Absolute queue index of the header.
+     *
+     * @return True once every put was handed over. False if the
+     * transport's ring filled up; the puts handed over so far are
+     * recorded and the next call resumes after them.
+     *
+     * @note The caller must hold the claim on queue_idx.
+     */
+    bool ro_net_unpack_batch(int queue_idx,
+                             const queue_element_t *header,
+                             uint64_t read_idx);
 
     /**
      * @brief The host-facing interface that will be used
@@ -157,8 +186,14 @@ class ROBackend : public Backend {
     Status reset_backend_stats() override;
 
     /**
-     * @brief Service thread routine which spins on a number of queues until
-     * the host calls net_finalize.
+     * @brief Service thread routine which spins on the queues until the
+     * host calls net_finalize.
+     *
+     * Queues are not bound to threads. Each pass scans the activity
+     * bitmap, starting at a word staggered by thread_id, and drains the
+     * active queues it can claim. A busy queue held by one poller is
+     * skipped by the others, which move on to the remaining queues.
+     * Pollers which find no work back off as RO_NET_PROGRESS_POLICY says.
      *
      * @param[in] thread_id
      * @param[in] num_threads
@@ -168,6 +203,38 @@ class ROBackend : public Backend {
      */
     void ro_net_poll(int thread_id, int num_threads);
 
+    /**
+     * @brief Try to take exclusive ownership of a queue.
+     *
+     * @param[in] queue_idx Index of the queue.
+     *
+     * @return True if the caller now owns the queue.
+     */
+    bool claim_queue(size_t queue_idx);
+
+    /**
+     * @brief Set the activity bit of a queue so the pollers visit it.
+     *
+     * @param[in] queue_idx Index of the queue.
+     */
+    void mark_queue_active(size_t queue_idx);
+
+    /**
+     * @brief Give up ownership of a queue taken with claim_queue.
+     *
+     * @param[in] queue_idx Index of the queue.
+     */
+    void release_queue(size_t queue_idx);
+
+    /**
+     * @brief Block the calling poller until a block posts to a queue.
+     *
+     * Used with RO_NET_PROGRESS_POLICY=sleep once a poller has backed off.
+     * Returns early if a queue is already active and returns after
+     * RO_NET_PROGRESS_SLEEP_US at the latest.
+     */
+    void wait_for_post();
+
     /**
      * @brief Helper to initialize IPC interface.
      */
@@ -193,6 +260,30 @@ class ROBackend : public Backend {
      */
     std::vector<std::thread> worker_threads {};
 
+    /**
+     * @brief One flag per queue; set while a worker drains the queue.
+     */
+    std::vector<std::atomic<bool>> queue_claimed_ {};
+
+    /**
+     * @brief Per queue, the puts of the batch at its read index which were
+     * already handed to the transport.
+     */
+    std::vector<int> batch_progress_ {};
+
+    /**
+     * @brief Per queue, the read index as known to the poller.
+     *
+     * Advanced for every element consumed but copied to the queue
+     * descriptor, where the device reads its credits, only once per drain.
+     */
+    std::vector<uint64_t> read_idx_ {};
+
+    /**
+     * @brief Maximum number of elements drained from a queue per claim.
+     */
+    static constexpr int MAX_DRAIN_PER_CLAIM {64};
+
     /**
      * @brief Holds a copy of the default context for host functions
      */
@@ -255,19 +346,23 @@ class ROBackend : public Backend {
     QueueDescProxyT queue_desc_proxy_ {};
 
     /**
-     * @brief Host buffer for device memory copies
+     * @brief One bit per queue which is set when the device posts to it.
      *
      * @note Internal data ownership is managed by the proxy
      */
-    QueueElementProxyT queue_element_proxy_ {};
+    ActivityBitmapProxyT activity_bitmap_proxy_ {};
 
     /**
-     * @brief Host-side buffer which holds a single device-side queue element.
+     * @brief Host buffers for device memory copies, one per worker.
+     *
+     * Each buffer holds a single device-side queue element. They are an
+     * optimization to access the queue elements in device memory, and
+     * are private to a worker so concurrent pollers do not overwrite each
+     * other's copies.
      *
-     * This small buffer is intended to be used as an optimization to access
-     * the queue elements in device memory.
+     * @note Internal data ownership is managed by the proxies
      */
-    queue_element_t *queue_element_cache_ {queue_element_proxy_.get()};
+    std::vector<std::unique_ptr<QueueElementProxyT>> queue_element_proxies_ {};
 
     /**
      * @brief Proxy for the default context
@@ -63,6 +63,10 @@ ROContext::ROContext(Backend *b, long option)
     backend_ctx->read_idx = proxy->queue_descs[buffer_id].read_idx;
     backend_ctx->status = proxy->queue_descs[buffer_id].status;
     backend_ctx->host_read_idx = &proxy->queue_descs[buffer_id].read_idx;
+    backend_ctx->activity_word = &proxy->activity_bitmap[buffer_id / 64];
+    backend_ctx->activity_mask = uint64_t{1} << (buffer_id % 64);
+    backend_ctx->sleeping_pollers = proxy->sleeping_pollers;
+    backend_ctx->poller_signal = proxy->poller_signal;
     backend_ctx->queue = proxy->queues[buffer_id];
     backend_ctx->queue_size = proxy->queue_size;
     backend_ctx->barrier_ptr = proxy->barrier_ptr;
@@ -71,6 +75,9 @@ ROContext::ROContext(Backend *b, long option)
     backend_ctx->atomic_ret.atomic_counter = 0;
     ipcImpl_.ipc_bases = b->ipcImpl.ipc_bases;
     backend_ctx->profiler.resetStats();
+    backend_ctx->put_batch_enabled = proxy->put_batch;
+    backend_ctx->put_inline_enabled = proxy->put_inline;
+    backend_ctx->put_batch = {};
 }
 
 __device__
@@ -100,6 +107,10 @@ ROContext::ROContext(Backend *b, long option)
         backend_ctx->read_idx = proxy->queue_descs[buffer_id].read_idx;
         backend_ctx->status = proxy->queue_descs[buffer_id].status;
         backend_ctx->host_read_idx = &proxy->queue_descs[buffer_id].read_idx;
+        backend_ctx->activity_word = &proxy->activity_bitmap[buffer_id / 64];
+        backend_ctx->activity_mask = uint64_t{1} << (buffer_id % 64);
+        backend_ctx->sleeping_pollers = proxy->sleeping_pollers;
+        backend_ctx->poller_signal = proxy->poller_signal;
         backend_ctx->queue = proxy->queues[buffer_id];
         backend_ctx->queue_size = proxy->queue_size;
         backend_ctx->barrier_ptr = proxy->barrier_ptr;
@@ -107,6 +118,9 @@ ROContext::ROContext(Backend *b, long option)
         backend_ctx->atomic_ret.atomic_base_ptr = proxy->atomic_ret->atomic_base_ptr;
         backend_ctx->atomic_ret.atomic_counter = proxy->atomic_ret->atomic_counter;
         backend_ctx->profiler.resetStats();
+        backend_ctx->put_batch_enabled = proxy->put_batch;
+        backend_ctx->put_inline_enabled = proxy->put_inline;
+        backend_ctx->put_batch = {};
         // TODO: @Brandon Assuming that I am GPU 0, need ID for multi-GPU nodes!
         new (&backend_ctx->hdp_policy) HdpPolicy(*proxy->hdp_policy);
     }
@@ -134,7 +148,7 @@ ROContext::putmem(void *dest, const void *source, size_t nelems, int pe) {
         if (!must_send_message) {
             return;
         }
-        build_queue_element(RO_NET_PUT,
+        build_queue_element(put_cmd(nelems, true, backend_ctx),
                             dest,
                             (void*)source,
                             nelems,
@@ -193,7 +207,12 @@ ROContext::putmem_nbi(void *dest, const void *source, size_t nelems, int pe) {
         if (!must_send_message) {
             return;
         }
-        build_queue_element(RO_NET_PUT_NBI,
+        ro_net_cmds type = put_cmd(nelems, false, backend_ctx);
+        if (type == RO_NET_PUT_NBI &&
+            batch_put(dest, source, nelems, pe, backend_ctx)) {
+            return;
+        }
+        build_queue_element(type,
                             dest,
                             (void*)source,
                             nelems,
@@ -558,7 +577,7 @@ ROContext::putmem_wg(void *dest, const void *source, size_t nelems, int pe) {
                             nelems);
     } else {
         if (is_thread_zero_in_block()) {
-            build_queue_element(RO_NET_PUT,
+            build_queue_element(put_cmd(nelems, true, backend_ctx),
                                 dest,
                                 (void*)source,
                                 nelems,
@@ -615,7 +634,7 @@ ROContext::putmem_nbi_wg(void *dest, const void *source, size_t nelems, int pe)
                             nelems);
     } else {
         if (is_thread_zero_in_block()) {
-            build_queue_element(RO_NET_PUT_NBI,
+            build_queue_element(put_cmd(nelems, false, backend_ctx),
                                 dest,
                                 (void*)source,
                                 nelems,
@@ -672,7 +691,7 @@ ROContext::putmem_wave(void *dest, const void *source, size_t nelems, int pe) {
                               nelems);
     } else {
         if (is_thread_zero_in_wave()) {
-            build_queue_element(RO_NET_PUT,
+            build_queue_element(put_cmd(nelems, true, backend_ctx),
                                 dest,
                                 (void*)source,
                                 nelems,
@@ -727,7 +746,7 @@ ROContext::putmem_nbi_wave(void *dest, const void *source, size_t nelems, int pe
                               nelems);
     } else {
         if (is_thread_zero_in_wave()) {
-            build_queue_element(RO_NET_PUT_NBI,
+            build_queue_element(put_cmd(nelems, false, backend_ctx),
                                 dest,
                                 (void*)source,
                                 nelems,
@@ -773,11 +792,264 @@ ROContext::getmem_nbi_wave(void *dest, const void *source, size_t nelems, int pe
     }
 }
 
+/*
+ * Collectives carry their extra fields in an extension slot.
+ */
+__device__ static bool
+needsExtension(ro_net_cmds type) {
+    switch (type) {
+        case RO_NET_TO_ALL:
+        case RO_NET_TEAM_TO_ALL:
+        case RO_NET_BROADCAST:
+        case RO_NET_TEAM_BROADCAST:
+        case RO_NET_ALLTOALL:
+        case RO_NET_FCOLLECT:
+        case RO_NET_SYNC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Wait until the host has consumed the queue up to end_idx - queue_size,
+ * so every slot before end_idx is free. The work-group shares a cached
+ * copy of the host's read index and only goes to memory when it falls
+ * short.
+ */
+__device__ static void
+wait_for_credits(struct ro_net_wg_handle *handle,
+                 uint64_t end_idx) {
+    uint64_t start = handle->profiler.startTimer();
+    volatile uint64_t *cached_read_idx = &handle->read_idx;
+    while (end_idx - *cached_read_idx > handle->queue_size) {
+        uint64_t read_idx;
+        __asm__ volatile ("s_sleep 1\n"
+                          "global_load_dwordx2 %0 %1 off glc slc\n "
+                          "s_waitcnt vmcnt(0)" :
+                          "=v"(read_idx) :
+                          "v"(handle->host_read_idx));
+        atomicMax((unsigned long long*)&handle->read_idx, read_idx);
+    }
+    handle->profiler.endTimer(start, WAITING_ON_SLOT);
+}
+
+/*
+ * Slots reserved by one lane of a wavefront.
+ *
+ * The lanes reserve together but fill and post their slots one group
+ * at a time. No group spans more than queue_size slots from its first
+ * one, so its lanes get their credits once the earlier groups are
+ * posted and consumed, however many slots the whole wavefront takes.
+ */
+struct queue_slots {
+    uint64_t write_idx;
+    uint64_t group;
+    uint64_t num_groups;
+};
+
+/*
+ * Reserve num_slots (at most RO_NET_MAX_CMD_SLOTS) consecutive slots in
+ * the queue for each active lane with a single fetch-and-add per
+ * wavefront. Lanes take consecutive ranges in lane order.
+ *
+ * The offsets are a prefix sum of num_slots built from one ballot per
+ * bit; unlike a shuffle scan, ballots only count the active lanes.
+ * Callers must wait_for_credits before writing, group by group.
+ */
+__device__ static queue_slots
+reserve_queue_slots(struct ro_net_wg_handle *handle,
+                    uint64_t num_slots) {
+    unsigned long long *write_idx_ptr =
+        reinterpret_cast<unsigned long long*>(&handle->write_idx);
+    uint64_t lower_lanes = __ballot(1) & ((uint64_t{1} << __lane_id()) - 1);
+    uint64_t offset = 0;
+    uint64_t total = 0;
+    for (int bit = 0; (uint64_t{1} << bit) <= RO_NET_MAX_CMD_SLOTS; bit++) {
+        uint64_t lanes = __ballot((num_slots >> bit) & 1);
+        offset += static_cast<uint64_t>(__popcll(lanes & lower_lanes)) << bit;
+        total += static_cast<uint64_t>(__popcll(lanes)) << bit;
+    }
+
+    int leader = lowerID();
+    uint64_t base = 0;
+    if (__lane_id() == leader) {
+        base = atomicAdd(write_idx_ptr, total);
+    }
+    base = __shfl(base, leader);
+
+    // A lane starting anywhere in a group ends within queue_size slots
+    // of the group's start.
+    uint64_t group_slots = handle->queue_size - RO_NET_MAX_CMD_SLOTS + 1;
+    return {base + offset, offset / group_slots,
+            (total - 1) / group_slots + 1};
+}
+
+/*
+ * Publish a filled in command to the host and ring the doorbell.
+ */
+__device__ static void
+post_queue_element(struct ro_net_wg_handle *handle,
+                   queue_element_t *element,
+                   uint64_t write_idx) {
+    // Make sure queue element data is visible to CPU
+    uint64_t start = handle->profiler.startTimer();
+    __threadfence();
+    handle->profiler.endTimer(start, THREAD_FENCE_1);
+
+    // Make data as ready and make visible to CPU
+    start = handle->profiler.startTimer();
+    element->seq = queue_slot_seq(write_idx);
+    __threadfence();
+    handle->profiler.endTimer(start, THREAD_FENCE_2);
+
+    // Ring the doorbell so the host polls this queue. The element must be
+    // visible before the bit since the host clears the bit and then reads
+    // the queue.
+    __threadfence_system();
+    atomicOr(reinterpret_cast<unsigned long long*>(handle->activity_word),
+             static_cast<unsigned long long>(handle->activity_mask));
+
+    // With RO_NET_PROGRESS_POLICY=sleep, wake the pollers if they blocked.
+    // They count themselves as sleeping before their last look at the
+    // bitmap, so either they see the bit or we see them.
+    if (handle->sleeping_pollers) {
+        __threadfence_system();
+        unsigned int sleepers = 0;
+        __asm__ volatile ("global_load_dword %0 %1 off glc slc\n "
+                          "s_waitcnt vmcnt(0)" :
+                          "=v"(sleepers) :
+                          "v"(handle->sleeping_pollers));
+        if (sleepers) {
+            __ockl_hsa_signal_add(handle->poller_signal, 1, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+/*
+ * Send the pending puts of the work-group as one RO_NET_PUT_BATCH
+ * command: a header followed by the puts, two per slot. The caller holds
+ * the batch lock.
+ */
+__device__ static void
+post_put_batch(struct ro_net_wg_handle *handle) {
+    ro_net_put_batch *batch = &handle->put_batch;
+    int count = batch->count;
+    if (!count) {
+        return;
+    }
+
+    uint64_t num_ext = (count + RO_NET_BATCH_OPS_PER_SLOT - 1) /
+                       RO_NET_BATCH_OPS_PER_SLOT;
+    queue_slots slots = reserve_queue_slots(handle, 1 + num_ext);
+
+    for (uint64_t group = 0; group < slots.num_groups; group++) {
+        if (group != slots.group) {
+            continue;
+        }
+        uint64_t write_idx = slots.write_idx;
+        wait_for_credits(handle, write_idx + 1 + num_ext);
+
+        uint64_t start = handle->profiler.startTimer();
+        for (uint64_t i = 0; i < num_ext; i++) {
+            uint64_t ext_idx = write_idx + 1 + i;
+            queue_element_batch_t *ext =
+                reinterpret_cast<queue_element_batch_t*>(
+                    &handle->queue[ext_idx % handle->queue_size]);
+            for (int j = 0; j < RO_NET_BATCH_OPS_PER_SLOT; j++) {
+                int op = i * RO_NET_BATCH_OPS_PER_SLOT + j;
+                if (op < count) {
+                    ext->dst[j] = batch->dst[op];
+                    ext->src[j] = batch->src[op];
+                    ext->size[j] = batch->size[op];
+                }
+            }
+            ext->seq = queue_slot_seq(ext_idx);
+        }
+
+        queue_element_t *element =
+            &handle->queue[write_idx % handle->queue_size];
+        element->type = RO_NET_PUT_BATCH;
+        element->num_ext = num_ext;
+        element->PE = batch->pe;
+        element->size = count;
+        element->threadId = get_flat_block_id();
+        handle->profiler.endTimer(start, PACK_QUEUE);
+
+        post_queue_element(handle, element, write_idx);
+    }
+
+    batch->count = 0;
+    batch->bytes = 0;
+}
+
+/*
+ * Threads of one wavefront cannot spin on a lock held by another of its
+ * lanes, so the lock is only ever tried: the lane which wins runs the
+ * critical section inside the loop and the others try again after it.
+ */
+#define WITH_PUT_BATCH_LOCK(batch, critical_section)          \
+    do {                                                      \
+        bool done_ = false;                                   \
+        while (!done_) {                                      \
+            if (atomicCAS(&(batch)->lock, 0, 1) == 0) {       \
+                __threadfence_block();                        \
+                critical_section;                             \
+                __threadfence_block();                        \
+                atomicExch(&(batch)->lock, 0);                \
+                done_ = true;                                 \
+            }                                                 \
+        }                                                     \
+    } while (0)
+
+__device__ void
+flush_put_batch(struct ro_net_wg_handle *handle) {
+    ro_net_put_batch *batch = &handle->put_batch;
+    if (!*reinterpret_cast<volatile int*>(&batch->count)) {
+        return;
+    }
+    WITH_PUT_BATCH_LOCK(batch, post_put_batch(handle));
+}
+
 __device__ bool
-isFull(uint64_t read_idx,
-       uint64_t write_idx,
-       uint64_t queue_size) {
-    return ((queue_size - (write_idx - read_idx)) == 0);
+batch_put(void *dst,
+          const void *src,
+          size_t size,
+          int pe,
+          struct ro_net_wg_handle *handle) {
+    if (!handle->put_batch_enabled || size > RO_NET_BATCH_MAX_OP_BYTES) {
+        return false;
+    }
+    ro_net_put_batch *batch = &handle->put_batch;
+    WITH_PUT_BATCH_LOCK(batch, {
+        if (batch->count &&
+            (batch->pe != pe ||
+             batch->bytes + size > RO_NET_BATCH_MAX_BYTES)) {
+            post_put_batch(handle);
+        }
+        int op = batch->count;
+        batch->dst[op] = dst;
+        batch->src[op] = const_cast<void*>(src);
+        batch->size[op] = size;
+        batch->pe = pe;
+        batch->count = op + 1;
+        batch->bytes += size;
+        if (batch->count == RO_NET_BATCH_MAX_OPS ||
+            batch->bytes >= RO_NET_BATCH_MAX_BYTES) {
+            post_put_batch(handle);
+        }
+    });
+    return true;
+}
+
+__device__ ro_net_cmds
+put_cmd(size_t size,
+        bool blocking,
+        struct ro_net_wg_handle *handle) {
+    if (handle->put_inline_enabled && size <= RO_NET_INLINE_PUT_MAX_BYTES) {
+        return blocking ? RO_NET_PUT_INLINE : RO_NET_PUT_NBI_INLINE;
+    }
+    return blocking ? RO_NET_PUT : RO_NET_PUT_NBI;
 }
 
 __device__ void
@@ -799,108 +1071,92 @@ build_queue_element(ro_net_cmds type,
                     ro_net_types datatype) {
     int threadId = get_flat_block_id();
 
-    uint64_t start = handle->profiler.startTimer();
+    // Puts held back for batching go out ahead of any later command, so
+    // fences, quiets and reads issued by their threads observe them.
+    flush_put_batch(handle);
 
-    unsigned long long old_write_slot = handle->write_idx;
-    unsigned long long write_slot;
-    do {
-        write_slot = old_write_slot;
-        // If we think the queue might be full, poll on the in-memory read
-        // index.  Otherwise, we are good to go!  In the common case we never
-        // need to go to memory.
-        while (isFull(handle->read_idx, write_slot, handle->queue_size)) {
-            __asm__ volatile ("global_load_dwordx2 %0 %1 off glc slc\n "
-                              "s_waitcnt vmcnt(0)" :
-                              "=v"(handle->read_idx) :
-                              "v"(handle->host_read_idx));
+    uint64_t num_ext = 0;
+    if (needsExtension(type)) {
+        num_ext = 1;
+    } else if (is_inline_put(type)) {
+        num_ext = inline_put_slots(size);
+    }
+    queue_slots slots = reserve_queue_slots(handle, 1 + num_ext);
 
+    for (uint64_t group = 0; group < slots.num_groups; group++) {
+        if (group != slots.group) {
+            continue;
+        }
+        uint64_t write_idx = slots.write_idx;
+        wait_for_credits(handle, write_idx + 1 + num_ext);
+
+        uint64_t start = handle->profiler.startTimer();
+        queue_element_t *element =
+            &handle->queue[write_idx % handle->queue_size];
+        element->type = type;
+        element->num_ext = num_ext;
+        element->PE = pe;
+        element->size = size;
+        element->dst = dst;
+
+        // Inline commands will pack the data value in the src field.
+        if (type == RO_NET_P) {
+           memcpy(&element->src, src, size);
+        } else {
+           element->src = src;
         }
-        // Double check that our write_idx is still available and update it.
-        // If it isn't then we try again and validate that the new write
-        // index is available for the taking.
-        old_write_slot = atomicCAS((unsigned long long*)&handle->write_idx,
-                                   write_slot,
-                                   write_slot + 1);
-    } while (write_slot != old_write_slot);
-
-    handle->profiler.endTimer(start, WAITING_ON_SLOT);
 
-    start = handle->profiler.startTimer();
-    write_slot = write_slot % handle->queue_size;
-    handle->queue[write_slot].type = type;
-    handle->queue[write_slot].PE = pe;
-    handle->queue[write_slot].size = size;
-    handle->queue[write_slot].dst = dst;
-
-    // Inline commands will pack the data value in the src field.
-    if (type == RO_NET_P) {
-       memcpy(&handle->queue[write_slot].src, src, size);
-    } else {
-       handle->queue[write_slot].src = src;
-    }
+        // Inline puts copy their payload into the slots after the header,
+        // so the host sends it without reading device memory.
+        if (is_inline_put(type)) {
+            char *payload_src = reinterpret_cast<char*>(src);
+            for (uint64_t i = 0; i < num_ext; i++) {
+                uint64_t payload_idx = write_idx + 1 + i;
+                queue_element_payload_t *payload =
+                    reinterpret_cast<queue_element_payload_t*>(
+                        &handle->queue[payload_idx % handle->queue_size]);
+                size_t offset = i * RO_NET_INLINE_BYTES_PER_SLOT;
+                size_t bytes = size - offset;
+                if (bytes > RO_NET_INLINE_BYTES_PER_SLOT) {
+                    bytes = RO_NET_INLINE_BYTES_PER_SLOT;
+                }
+                memcpy(payload->data, payload_src + offset, bytes);
+                payload->seq = queue_slot_seq(payload_idx);
+            }
+        }
 
-    handle->queue[write_slot].threadId = threadId;
+        element->threadId = threadId;
 
-    if (type == RO_NET_AMO_FOP) {
-        handle->queue[write_slot].op = op;
-    }
-    if (type == RO_NET_AMO_FCAS) {
-        handle->queue[write_slot].pWrk = pWrk;
-    }
-    if (type == RO_NET_TO_ALL) {
-        handle->queue[write_slot].logPE_stride = logPE_stride;
-        handle->queue[write_slot].PE_size = PE_size;
-        handle->queue[write_slot].pWrk = pWrk;
-        handle->queue[write_slot].pSync = pSync;
-        handle->queue[write_slot].op = op;
-        handle->queue[write_slot].datatype = datatype;
-    }
-    if (type == RO_NET_TEAM_TO_ALL) {
-        handle->queue[write_slot].op = op;
-        handle->queue[write_slot].datatype = datatype;
-        handle->queue[write_slot].team_comm = team_comm;
-    }
-    if (type == RO_NET_BROADCAST) {
-        handle->queue[write_slot].logPE_stride = logPE_stride;
-        handle->queue[write_slot].PE_size = PE_size;
-        handle->queue[write_slot].pSync = pSync;
-        handle->queue[write_slot].PE_root = PE_root;
-        handle->queue[write_slot].datatype = datatype;
-    }
-    if (type == RO_NET_TEAM_BROADCAST) {
-        handle->queue[write_slot].PE_root = PE_root;
-        handle->queue[write_slot].datatype = datatype;
-        handle->queue[write_slot].team_comm = team_comm;
-    }
-    if (type == RO_NET_ALLTOALL) {
-        handle->queue[write_slot].datatype = datatype;
-        handle->queue[write_slot].team_comm = team_comm;
-        handle->queue[write_slot].pWrk = pWrk;
-    }
-    if (type == RO_NET_FCOLLECT) {
-        handle->queue[write_slot].datatype = datatype;
-        handle->queue[write_slot].team_comm = team_comm;
-        handle->queue[write_slot].pWrk = pWrk;
-    }
-    if(type == RO_NET_SYNC) {
-        handle->queue[write_slot].team_comm = team_comm;
-    }
+        if (type == RO_NET_AMO_FOP) {
+            element->op = op;
+        }
+        if (type == RO_NET_AMO_FCAS) {
+            element->cond = reinterpret_cast<int64_t>(pWrk);
+        }
 
-    handle->profiler.endTimer(start, PACK_QUEUE);
+        if (needsExtension(type)) {
+            uint64_t ext_idx = write_idx + 1;
+            queue_element_ext_t *ext = reinterpret_cast<queue_element_ext_t*>(
+                &handle->queue[ext_idx % handle->queue_size]);
+            element->op = op;
+            element->datatype = datatype;
+            ext->logPE_stride = logPE_stride;
+            ext->PE_size = PE_size;
+            ext->PE_root = PE_root;
+            ext->pWrk = pWrk;
+            ext->pSync = pSync;
+            ext->team_comm = team_comm;
+            ext->seq = queue_slot_seq(ext_idx);
+        }
 
-    // Make sure queue element data is visible to CPU
-    start = handle->profiler.startTimer();
-    __threadfence();
-    handle->profiler.endTimer(start, THREAD_FENCE_1);
+        handle->profiler.endTimer(start, PACK_QUEUE);
 
-    // Make data as ready and make visible to CPU
-    start = handle->profiler.startTimer();
-    handle->queue[write_slot].valid = 1;
-    __threadfence();
-    handle->profiler.endTimer(start, THREAD_FENCE_2);
+        post_queue_element(handle, element, write_idx);
+    }
 
-    // Blocking requires the CPU to complete the operation.
-    start = handle->profiler.startTimer();
+    // Blocking requires the CPU to complete the operation. Every group
+    // posts before any lane waits, so the host sees the whole wavefront.
+    uint64_t start = handle->profiler.startTimer();
     if (blocking) {
         int net_status = 0;
         do {
@@ -22,9 +22,14 @@
 
 #include "mpi_transport.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
 #include "backend_ro.hpp"
 #include "host.hpp"
 #include "ro_net_team.hpp"
+#include "thread_placement.hpp"
 
 namespace rocshmem {
 
@@ -37,8 +42,6 @@ namespace rocshmem {
 
 MPITransport::MPITransport()
     : Transport{} {
-    indices = new int[INDICES_SIZE];
-
     int init_done {};
     NET_CHECK(MPI_Initialized(&init_done));
 
@@ -57,41 +60,320 @@ MPITransport::MPITransport()
 }
 
 MPITransport::~MPITransport() {
-    delete [] indices;
 }
 
 void
-MPITransport::threadProgressEngine() {
+MPITransport::threadProgressEngine(ProgressShard *shard) {
     auto *bp {backend_proxy->get()};
 
-    transport_up = true;
+    IdleBackoff backoff {bp->progress_policy.mode};
+
+    running_threads++;
     while (!(bp->done_flag)) {
-        submitRequestsToMPI();
-        progress();
+        auto count {submitRequestsToMPI(*shard)};
+        count += progressShard(*shard);
+        count += resumeParked(*shard);
+
+        /*
+         * Outstanding requests need MPI to be polled, so the shard only
+         * backs off once it has none. The timeout bounds how long MPI goes
+         * without progress for incoming operations.
+         */
+        if (count || !shard->req_vec.empty()) {
+            backoff.reset();
+        } else if (backoff.idle()) {
+            auto &doorbell {shard->work_doorbell};
+            auto ticket {doorbell.arm()};
+            if (!shard->request_ring->size() && !bp->done_flag) {
+                doorbell.wait(ticket, bp->progress_policy.max_sleep);
+            } else {
+                doorbell.disarm();
+            }
+        }
     }
-    transport_up = false;
+    running_threads--;
+}
+
+MPITransport::ProgressShard&
+MPITransport::shardOf(int wg_id) {
+    return *shards[static_cast<size_t>(wg_id) % shards.size()];
 }
 
 void
+MPITransport::trackRequest(MPI_Request request,
+                           const RequestProperties &properties) {
+    auto &shard {shardOf(properties.wgId)};
+    shard.req_prop_vec.push_back(properties);
+    shard.req_vec.push_back(request);
+    outstanding[properties.wgId]++;
+}
+
+bool
 MPITransport::insertRequest(const queue_element_t *element,
+                            const queue_element_ext_t *ext,
+                            const char *payload,
                             int queue_id) {
-    std::unique_lock<std::mutex> mlock(queue_mutex);
-    q.push(element);
-    q_wgid.push(queue_id);
+    auto &shard {shardOf(queue_id)};
+    QueuedRequest request {*element, {}, queue_id};
+    if (ext) {
+        request.ext = *ext;
+    }
+    if (payload) {
+        ::memcpy(request.payload, payload, element->size);
+    }
+    if (!shard.request_ring->push(request)) {
+        return false;
+    }
+    if (progress_sleeps) {
+        shard.work_doorbell.ring();
+    }
+    return true;
 }
 
 void
-MPITransport::submitRequestsToMPI() {
-    if (q.empty())
+MPITransport::wakeProgressThreads() {
+    for (auto &shard : shards) {
+        shard->work_doorbell.ring();
+    }
+}
+
+static bool
+isRMA(uint8_t type) {
+    switch (type) {
+        case RO_NET_PUT:
+        case RO_NET_P:
+        case RO_NET_GET:
+        case RO_NET_PUT_NBI:
+        case RO_NET_GET_NBI:
+        case RO_NET_PUT_INLINE:
+        case RO_NET_PUT_NBI_INLINE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t
+MPITransport::submitRequestsToMPI(ProgressShard &shard) {
+    auto &submit_batch {shard.submit_batch};
+    auto &submit_batch_size {shard.submit_batch_size};
+    auto count {shard.request_ring->pop(submit_batch.data(),
+                                        submit_batch_size)};
+
+    /*
+     * Grow the batch while the ring keeps it full and shrink it when the
+     * ring runs dry, so bursts are drained with few progress calls while
+     * a lone blocking request is not held behind a large batch.
+     */
+    if (count == submit_batch_size) {
+        submit_batch_size = std::min(submit_batch_size * 2,
+                                     MAX_SUBMIT_BATCH_SIZE);
+    } else if (count < submit_batch_size / 4) {
+        submit_batch_size = std::max(submit_batch_size / 2,
+                                     MIN_SUBMIT_BATCH_SIZE);
+    }
+
+    size_t begin {0};
+    while (begin < count) {
+        if (!isRMA(submit_batch[begin].element.type)) {
+            submitRequest(&submit_batch[begin].element,
+                          &submit_batch[begin].ext,
+                          nullptr,
+                          submit_batch[begin].queue_idx);
+            begin++;
+            continue;
+        }
+
+        size_t end {begin + 1};
+        while (end < count && isRMA(submit_batch[end].element.type)) {
+            end++;
+        }
+        submitRMAGroup(shard, begin, end);
+        begin = end;
+    }
+    return count;
+}
+
+void
+MPITransport::submitRMAGroup(ProgressShard &shard,
+                             size_t begin,
+                             size_t end) {
+    auto *bp {backend_proxy->get()};
+    auto &submit_batch {shard.submit_batch};
+
+    /*
+     * Order the run by window and target PE with a stable insertion sort
+     * on indices. Runs are short and this allocates nothing. Requests
+     * from one work-group to one PE keep their order; other pairs are
+     * unordered until a fence or quiet, which ends the run.
+     */
+    auto key = [&](size_t i) {
+        const auto &request {submit_batch[i]};
+        auto *window_info {bp->heap_window_info[request.queue_idx]};
+        return std::make_pair(reinterpret_cast<uintptr_t>(window_info),
+                              request.element.PE);
+    };
+    auto *order {shard.submit_order.data()};
+    size_t length {end - begin};
+    for (size_t i {0}; i < length; i++) {
+        auto index {begin + i};
+        auto index_key {key(index)};
+        auto j {i};
+        while (j && index_key < key(order[j - 1])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = index;
+    }
+
+    for (size_t i {0}; i < length; i++) {
+        const auto &request {submit_batch[order[i]]};
+        submitRequest(&request.element,
+                      nullptr,
+                      request.payload,
+                      request.queue_idx);
+    }
+}
+
+void
+MPITransport::markDirty(int wg_id, int pe) {
+    auto index {static_cast<size_t>(wg_id) * num_pes + pe};
+    if (!is_dirty[index]) {
+        is_dirty[index] = true;
+        dirty_pes[wg_id].push_back(pe);
+    }
+}
+
+void
+MPITransport::flushTarget(int wg_id, int pe) {
+    auto index {static_cast<size_t>(wg_id) * num_pes + pe};
+    if (!is_dirty[index]) {
         return;
+    }
+    auto *bp {backend_proxy->get()};
+    NET_CHECK(MPI_Win_flush(pe, bp->heap_window_info[wg_id]->get_win()));
+    is_dirty[index] = false;
+
+    auto &pes {dirty_pes[wg_id]};
+    auto it {std::find(pes.begin(), pes.end(), pe)};
+    *it = pes.back();
+    pes.pop_back();
+}
+
+void
+MPITransport::flushDirty(int wg_id) {
+    auto &pes {dirty_pes[wg_id]};
+    if (pes.empty()) {
+        return;
+    }
+    auto *bp {backend_proxy->get()};
+    auto win {bp->heap_window_info[wg_id]->get_win()};
+    for (auto pe : pes) {
+        NET_CHECK(MPI_Win_flush(pe, win));
+        is_dirty[static_cast<size_t>(wg_id) * num_pes + pe] = false;
+    }
+    pes.clear();
+}
+
+void
+MPITransport::submitRequest(const queue_element_t *next_element,
+                            const queue_element_ext_t *next_ext,
+                            const char *payload,
+                            int queue_idx) {
+    /*
+     * A flush only covers issued chunks, so a request which must observe
+     * a chunked put waits until the put has completed, and so do the
+     * later requests of its work-group to keep them in order.
+     */
+    auto &held {parked[queue_idx]};
+    if (held.empty() && !waitsForTransfers(*next_element, queue_idx)) {
+        dispatchRequest(next_element, next_ext, payload, queue_idx);
+        return;
+    }
+
+    QueuedRequest request {*next_element, {}, queue_idx};
+    if (next_ext) {
+        request.ext = *next_ext;
+    }
+    if (payload) {
+        ::memcpy(request.payload, payload, next_element->size);
+    }
+    held.push_back(request);
+    shardOf(queue_idx).num_parked++;
+}
+
+bool
+MPITransport::waitsForTransfers(const queue_element_t &element,
+                                int wg_id) {
+    switch (element.type) {
+        case RO_NET_PUT:
+        case RO_NET_P:
+        case RO_NET_PUT_NBI:
+        case RO_NET_PUT_INLINE:
+        case RO_NET_PUT_NBI_INLINE:
+            return false;
+        case RO_NET_GET:
+        case RO_NET_GET_NBI:
+        case RO_NET_AMO_FOP:
+        case RO_NET_AMO_FCAS:
+            return hasPendingPuts(wg_id, element.PE);
+        default:
+            return hasPendingPuts(wg_id, -1);
+    }
+}
 
-    std::unique_lock<std::mutex> mlock(queue_mutex);
+size_t
+MPITransport::resumeParked(ProgressShard &shard) {
+    size_t count {0};
+    while (!shard.resumable.empty()) {
+        auto wg_id {shard.resumable.back()};
+        shard.resumable.pop_back();
+
+        auto &held {parked[wg_id]};
+        while (!held.empty() && !waitsForTransfers(held.front().element,
+                                                   wg_id)) {
+            auto request {held.front()};
+            held.pop_front();
+            shard.num_parked--;
+            bool rma {isRMA(request.element.type)};
+            dispatchRequest(&request.element,
+                            rma ? nullptr : &request.ext,
+                            rma ? request.payload : nullptr,
+                            wg_id);
+            count++;
+        }
+    }
+    return count;
+}
 
-    const queue_element_t *next_element {q.front()};
-    int queue_idx {q_wgid.front()};
-    q.pop();
-    q_wgid.pop();
-    mlock.unlock();
+void
+MPITransport::dispatchRequest(const queue_element_t *next_element,
+                              const queue_element_ext_t *next_ext,
+                              const char *payload,
+                              int queue_idx) {
+    /*
+     * Puts only mark their target dirty. Gets and atomics must observe
+     * earlier puts to their target, and every other operation (quiet,
+     * fence, barriers and collectives) must observe all of them, so
+     * flush the work-group's dirty targets first.
+     */
+    switch (next_element->type) {
+        case RO_NET_PUT:
+        case RO_NET_P:
+        case RO_NET_PUT_NBI:
+        case RO_NET_PUT_INLINE:
+        case RO_NET_PUT_NBI_INLINE:
+            break;
+        case RO_NET_GET:
+        case RO_NET_GET_NBI:
+        case RO_NET_AMO_FOP:
+        case RO_NET_AMO_FCAS:
+            flushTarget(queue_idx, next_element->PE);
+            break;
+        default:
+            flushDirty(queue_idx);
+            break;
+    }
 
     switch (next_element->type) {
         case RO_NET_PUT:
@@ -102,7 +384,7 @@ MPITransport::submitRequestsToMPI() {
                    queue_idx,
                    next_element->threadId,
                    true);
-            DPRINTF("Received PUT dst %p src %p size %d pe %d\n",
+            DPRINTF("Received PUT dst %p src %p size %ld pe %d\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
@@ -110,9 +392,9 @@ MPITransport::submitRequestsToMPI() {
             break;
         case RO_NET_P: {
             // No equivalent inline OP for MPI.
-            // Allocate a temp buffer for value.
-            // TODO: @Brandon this is a memory leak - fix it
-            void *source_buffer {malloc(next_element->size)};
+            // Stage the value in a pooled slot until the put completes.
+            assert(next_element->size <= sizeof(InlinePayload));
+            void *source_buffer {acquirePayload(shardOf(queue_idx))};
 
             ::memcpy(source_buffer,
                      &next_element->src,
@@ -132,6 +414,31 @@ MPITransport::submitRequestsToMPI() {
                     next_element->PE);
             break;
         }
+        case RO_NET_PUT_INLINE:
+        case RO_NET_PUT_NBI_INLINE: {
+            // The payload came with the command; stage it like RO_NET_P
+            // so the NIC reads host memory instead of the device source.
+            assert(next_element->size <= sizeof(InlinePayload));
+            void *source_buffer {acquirePayload(shardOf(queue_idx))};
+
+            ::memcpy(source_buffer,
+                     payload,
+                     next_element->size);
+
+            putMem(next_element->dst,
+                   source_buffer,
+                   next_element->size,
+                   next_element->PE,
+                   queue_idx,
+                   next_element->threadId,
+                   next_element->type == RO_NET_PUT_INLINE,
+                   true);
+            DPRINTF("Received inline PUT dst %p size %ld pe %d\n",
+                    next_element->dst,
+                    next_element->size,
+                    next_element->PE);
+            break;
+        }
         case RO_NET_GET:
             getMem(next_element->dst,
                    next_element->src,
@@ -140,7 +447,7 @@ MPITransport::submitRequestsToMPI() {
                    queue_idx,
                    next_element->threadId,
                    true);
-            DPRINTF("Received GET dst %p src %p size %d pe %d\n",
+            DPRINTF("Received GET dst %p src %p size %ld pe %d\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
@@ -154,7 +461,7 @@ MPITransport::submitRequestsToMPI() {
                    queue_idx,
                    next_element->threadId,
                    false);
-            DPRINTF("Received PUT NBI dst %p src %p size %d pe %d\n",
+            DPRINTF("Received PUT NBI dst %p src %p size %ld pe %d\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
@@ -169,7 +476,7 @@ MPITransport::submitRequestsToMPI() {
                    queue_idx,
                    next_element->threadId,
                    false);
-            DPRINTF("Received GET NBI dst %p src %p size %d pe %d\n",
+            DPRINTF("Received GET NBI dst %p src %p size %ld pe %d\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
@@ -198,29 +505,29 @@ MPITransport::submitRequestsToMPI() {
                     queue_idx,
                     next_element->threadId,
                     true,
-                    (int64_t)next_element->pWrk);
+                    next_element->cond);
             DPRINTF("Received F_CSWAP dst %p src %p Val %d pe %d cond %ld\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
                     next_element->PE,
-                    (int64_t)next_element->pWrk);
+                    next_element->cond);
             break;
         case RO_NET_TEAM_TO_ALL:
             team_reduction(next_element->dst,
                            next_element->src,
                            next_element->size,
                            queue_idx,
-                           next_element->team_comm,
+                           next_ext->team_comm,
                            (ROC_SHMEM_OP)next_element->op,
                            (ro_net_types)next_element->datatype,
                            next_element->threadId,
                            true);
-            DPRINTF("Received FLOAT_SUM_TEAM_TO_ALL dst %p src %p size %d team %d\n",
+            DPRINTF("Received FLOAT_SUM_TEAM_TO_ALL dst %p src %p size %ld team %d\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
-                    next_element->team_comm);
+                    next_ext->team_comm);
             break;
         case RO_NET_TO_ALL:
             reduction(next_element->dst,
@@ -229,42 +536,42 @@ MPITransport::submitRequestsToMPI() {
                       next_element->PE,
                       queue_idx,
                       next_element->PE,
-                      next_element->logPE_stride,
-                      next_element->PE_size,
-                      next_element->pWrk,
-                      next_element->pSync,
+                      next_ext->logPE_stride,
+                      next_ext->PE_size,
+                      next_ext->pWrk,
+                      next_ext->pSync,
                       (ROC_SHMEM_OP)next_element->op,
                       (ro_net_types)next_element->datatype,
                       next_element->threadId,
                       true);
-            DPRINTF("Received FLOAT_SUM_TO_ALL dst %p src %p size %d "
-                    "PE_start %d, logPE_stride %d, PE_size %d, pWrk %p, pSync %p\n",
+            DPRINTF("Received FLOAT_SUM_TO_ALL dst %p src %p size %ld "
+                    "PE_start %d, logPE_stride %d, PE_size %ld, pWrk %p, pSync %p\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
                     next_element->PE,
-                    next_element->logPE_stride,
-                    next_element->PE_size,
-                    next_element->pWrk,
-                    next_element->pSync);
+                    next_ext->logPE_stride,
+                    next_ext->PE_size,
+                    next_ext->pWrk,
+                    next_ext->pSync);
             break;
         case RO_NET_TEAM_BROADCAST:
             team_broadcast(next_element->dst,
                            next_element->src,
                            next_element->size,
                            queue_idx,
-                           next_element->team_comm,
-                           next_element->PE_root,
+                           next_ext->team_comm,
+                           next_ext->PE_root,
                            (ro_net_types)next_element->datatype,
                            next_element->threadId,
                            true);
-            DPRINTF("Received TEAM_BROADCAST dst %p src %p size %d "
+            DPRINTF("Received TEAM_BROADCAST dst %p src %p size %ld "
                     "team %d, PE_root %d \n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
-                    next_element->team_comm,
-                    next_element->PE_root);
+                    next_ext->team_comm,
+                    next_ext->PE_root);
             break;
         case RO_NET_BROADCAST:
             broadcast(next_element->dst,
@@ -272,54 +579,54 @@ MPITransport::submitRequestsToMPI() {
                       next_element->size,
                       next_element->PE, queue_idx,
                       next_element->PE,
-                      next_element->logPE_stride,
-                      next_element->PE_size,
-                      next_element->PE_root,
-                      next_element->pSync,
+                      next_ext->logPE_stride,
+                      next_ext->PE_size,
+                      next_ext->PE_root,
+                      next_ext->pSync,
                       (ro_net_types)next_element->datatype,
                       next_element->threadId,
                       true);
-            DPRINTF("Received BROADCAST dst %p src %p size %d PE_start %d, "
-                    "logPE_stride %d, PE_size %d, PE_root %d, pSync %p\n",
+            DPRINTF("Received BROADCAST dst %p src %p size %ld PE_start %d, "
+                    "logPE_stride %d, PE_size %ld, PE_root %d, pSync %p\n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
                     next_element->PE,
-                    next_element->logPE_stride,
-                    next_element->PE_size,
-                    next_element->PE_root,
-                    next_element->pSync);
+                    next_ext->logPE_stride,
+                    next_ext->PE_size,
+                    next_ext->PE_root,
+                    next_ext->pSync);
             break;
         case RO_NET_ALLTOALL:
             alltoall(next_element->dst,
                      next_element->src,
                      next_element->size, queue_idx,
-                     next_element->team_comm,
-                     next_element->pWrk,
+                     next_ext->team_comm,
+                     next_ext->pWrk,
                      (ro_net_types) next_element->datatype,
                      next_element->threadId, true);
 
-            DPRINTF(("Received ALLTOALL  dst %p src %p size %d team %d \n",
+            DPRINTF(("Received ALLTOALL  dst %p src %p size %ld team %d \n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
-                    next_element->team_comm));
+                    next_ext->team_comm));
 
             break;
         case RO_NET_FCOLLECT:
             fcollect(next_element->dst,
                      next_element->src,
                      next_element->size, queue_idx,
-                     next_element->team_comm,
-                     next_element->pWrk,
+                     next_ext->team_comm,
+                     next_ext->pWrk,
                      (ro_net_types) next_element->datatype,
                      next_element->threadId, true);
 
-            DPRINTF(("Received FCOLLECT  dst %p src %p size %d team %d \n",
+            DPRINTF(("Received FCOLLECT  dst %p src %p size %ld team %d \n",
                     next_element->dst,
                     next_element->src,
                     next_element->size,
-                    next_element->team_comm));
+                    next_ext->team_comm));
 
             break;
         case RO_NET_BARRIER_ALL:
@@ -329,7 +636,7 @@ MPITransport::submitRequestsToMPI() {
             break;
         case RO_NET_SYNC:
             barrier(queue_idx, next_element->threadId, true,
-            	next_element->team_comm);
+            	next_ext->team_comm);
             DPRINTF(("Received Sync\n"));
             break;
         case RO_NET_FENCE:
@@ -346,8 +653,6 @@ MPITransport::submitRequestsToMPI() {
             exit(1);
             break;
     }
-
-    delete next_element;
 }
 
 Status
@@ -355,17 +660,77 @@ MPITransport::initTransport(int num_queues,
                             BackendProxyT *proxy) {
     waiting_quiet.resize(num_queues, std::vector<int>());
     outstanding.resize(num_queues, 0);
-    transport_up = false;
 
     backend_proxy = proxy;
     auto *bp {backend_proxy->get()};
 
+    dirty_pes.resize(num_queues);
+    parked.resize(num_queues);
+    is_dirty.assign(static_cast<size_t>(num_queues) * num_pes, false);
+    progress_sleeps = bp->progress_policy.mode == ProgressMode::SLEEP;
+
+    int num_shards {1};
+    if (char *value = getenv("RO_NET_NUM_PROGRESS_THREADS")) {
+        num_shards = std::max(atoi(value), 1);
+    }
+    num_shards = std::min(num_shards, num_queues);
+
+    if (char *value = getenv("RO_NET_RMA_CHUNK_SIZE")) {
+        chunk_size = std::clamp<size_t>(strtoull(value, nullptr, 10),
+                                        RO_NET_INLINE_PUT_MAX_BYTES,
+                                        MAX_CHUNK_SIZE);
+    }
+    if (char *value = getenv("RO_NET_RMA_CHUNKS_IN_FLIGHT")) {
+        chunks_in_flight = std::max(atoi(value), 1);
+    }
+
+    int provided {};
+    NET_CHECK(MPI_Query_thread(&provided));
+    if (num_shards > 1 && provided != MPI_THREAD_MULTIPLE) {
+        fprintf(stderr, "Warning multiple progress threads need "
+                        "MPI_THREAD_MULTIPLE, using one\n");
+        num_shards = 1;
+    }
+
+    /*
+     * Hold every element the shard's device queues can have in flight so
+     * the pollers only see a full ring when the progress thread falls
+     * behind. One payload slot per device queue element; if more inline
+     * puts than that are still in flight, acquirePayload drives progress
+     * until one of them completes.
+     */
+    auto queues_per_shard {(num_queues + num_shards - 1) / num_shards};
+    auto shard_elements {static_cast<size_t>(queues_per_shard) *
+                         bp->queue_size};
+    for (int i {0}; i < num_shards; i++) {
+        auto shard {std::make_unique<ProgressShard>()};
+        shard->request_ring =
+            std::make_unique<RequestRing<QueuedRequest>>(shard_elements);
+        shard->submit_batch.resize(MAX_SUBMIT_BATCH_SIZE);
+        shard->submit_order.resize(MAX_SUBMIT_BATCH_SIZE);
+        shard->req_vec.reserve(REQUEST_TABLE_RESERVE);
+        shard->req_prop_vec.reserve(REQUEST_TABLE_RESERVE);
+        shard->indices.resize(INDICES_SIZE);
+        shard->payload_pool.resize(shard_elements);
+        shard->free_payloads.reserve(shard_elements);
+        for (auto &payload : shard->payload_pool) {
+            shard->free_payloads.push_back(&payload);
+        }
+        shards.push_back(std::move(shard));
+    }
+
     host_interface = new HostInterface(bp->hdp_policy,
                                        ro_net_comm_world,
                                        bp->heap_ptr);
-    progress_thread =
-        new std::thread(&MPITransport::threadProgressEngine, this);
-    while (!transport_up) {
+    auto placement {ThreadPlacement::from_env("RO_NET_PROGRESS_CPUS")};
+    for (size_t i {0}; i < shards.size(); i++) {
+        auto *shard {shards[i].get()};
+        shard->thread = std::thread(&MPITransport::threadProgressEngine,
+                                    this,
+                                    shard);
+        placement.apply(shard->thread, i);
+    }
+    while (running_threads != num_shards) {
         ;
     }
     return Status::ROC_SHMEM_SUCCESS;
@@ -373,8 +738,9 @@ MPITransport::initTransport(int num_queues,
 
 Status
 MPITransport::finalizeTransport() {
-    progress_thread->join();
-    delete progress_thread;
+    for (auto &shard : shards) {
+        shard->thread.join();
+    }
     delete host_interface;
     return Status::ROC_SHMEM_SUCCESS;
 }
@@ -414,6 +780,7 @@ MPITransport::createComm(int start,
                          int stride,
                          int size) {
     CommKey key(start, stride, size);
+    std::lock_guard<std::mutex> lock(comm_map_mutex);
     auto it {comm_map.find(key)};
     if (it != comm_map.end()) {
         DPRINTF("Using cached communicator\n");
@@ -460,9 +827,7 @@ MPITransport::barrier(int wg_id,
     MPI_Request request {};
     NET_CHECK(MPI_Ibarrier(team, &request));
 
-    req_prop_vec.emplace_back(threadId, wg_id, blocking);
-    req_vec.push_back(request);
-    outstanding[wg_id]++;
+    trackRequest(request, {threadId, wg_id, blocking});
 
     return Status::ROC_SHMEM_SUCCESS;
 }
@@ -551,9 +916,7 @@ MPITransport::reduction(void *dst,
                                  &request));
     }
 
-    req_prop_vec.emplace_back(threadId, wg_id, blocking);
-    req_vec.push_back(request);
-    outstanding[wg_id]++;
+    trackRequest(request, {threadId, wg_id, blocking});
     return Status::ROC_SHMEM_SUCCESS;
 }
 
@@ -588,10 +951,7 @@ MPITransport::broadcast(void *dst,
     MPI_Datatype mpi_type {convertType(type)};
     NET_CHECK(MPI_Ibcast(data, size, mpi_type, root, comm, &request));
 
-    req_prop_vec.emplace_back(threadId, wg_id, blocking);
-    req_vec.push_back(request);
-
-    outstanding[wg_id]++;
+    trackRequest(request, {threadId, wg_id, blocking});
     return Status::ROC_SHMEM_SUCCESS;
 }
 
@@ -626,9 +986,7 @@ MPITransport::team_reduction(void *dst,
                                  &request));
     }
 
-    req_prop_vec.emplace_back(threadId, wg_id, blocking);
-    req_vec.push_back(request);
-    outstanding[wg_id]++;
+    trackRequest(request, {threadId, wg_id, blocking});
     return Status::ROC_SHMEM_SUCCESS;
 }
 
@@ -662,9 +1020,7 @@ MPITransport::team_broadcast(void *dst,
                          comm,
                          &request));
 
-    req_prop_vec.emplace_back(threadId, wg_id, blocking);
-    req_vec.push_back(request);
-    outstanding[wg_id]++;
+    trackRequest(request, {threadId, wg_id, blocking});
     return Status::ROC_SHMEM_SUCCESS;
 }
 
@@ -1290,7 +1646,7 @@ MPITransport::fcollect_gcen2(void *dst, void *src, int size, int wg_id,
 Status
 MPITransport::putMem(void *dst,
                      void *src,
-                     int size,
+                     size_t size,
                      int pe,
                      int wg_id,
                      int threadId,
@@ -1306,26 +1662,163 @@ MPITransport::putMem(void *dst,
         bp->hdp_policy->hdp_flush();
     }
 
+    // Inline data sits in a payload slot which the completion of its
+    // single request releases, so it is never split into chunks.
+    if (size > chunk_size && !inline_data) {
+        startTransfer({static_cast<char*>(dst), static_cast<char*>(src), size,
+                       0, 0, pe, wg_id, threadId, blocking, false});
+        return Status::ROC_SHMEM_SUCCESS;
+    }
+
+    issueRMA(false, dst, src, size, pe, wg_id,
+             {threadId, wg_id, blocking, src, inline_data});
+    return Status::ROC_SHMEM_SUCCESS;
+}
+
+void
+MPITransport::issueRMA(bool is_get,
+                       void *dst,
+                       void *src,
+                       size_t size,
+                       int pe,
+                       int wg_id,
+                       const RequestProperties &properties) {
+    auto *bp {backend_proxy->get()};
+    auto *window_info {bp->heap_window_info[wg_id]};
+    auto count {static_cast<int>(size)};
+
     MPI_Request request {};
-    NET_CHECK(MPI_Rput(src,
-                       size,
-                       MPI_CHAR,
-                       pe,
-                       bp->heap_window_info[wg_id]->get_offset(dst),
-                       size,
-                       MPI_CHAR,
-                       bp->heap_window_info[wg_id]->get_win(),
-                       &request));
+    if (is_get) {
+        NET_CHECK(MPI_Rget(dst,
+                           count,
+                           MPI_CHAR,
+                           pe,
+                           window_info->get_offset(src),
+                           count,
+                           MPI_CHAR,
+                           window_info->get_win(),
+                           &request));
+    } else {
+        NET_CHECK(MPI_Rput(src,
+                           count,
+                           MPI_CHAR,
+                           pe,
+                           window_info->get_offset(dst),
+                           count,
+                           MPI_CHAR,
+                           window_info->get_win(),
+                           &request));
+
+        // MPI completes puts as soon as the local buffer is free, so the
+        // target is flushed later by the first quiet, fence or blocking
+        // operation of this work-group which needs it.
+        markDirty(wg_id, pe);
+    }
 
-    // Since MPI makes puts as complete as soon as the local buffer is free,
-    // we need a flush to satisfy quiet.  Put it here as a hack for now even
-    // though it should be in the progress loop.
-    NET_CHECK(MPI_Win_flush_all(bp->heap_window_info[wg_id]->get_win()));
+    trackRequest(request, properties);
+}
 
-    req_prop_vec.emplace_back(threadId, wg_id, blocking, src, inline_data);
-    req_vec.push_back(request);
-    outstanding[wg_id]++;
-    return Status::ROC_SHMEM_SUCCESS;
+void
+MPITransport::startTransfer(const ChunkedTransfer &transfer) {
+    auto &shard {shardOf(transfer.wg_id)};
+    int index {};
+    if (shard.free_transfers.empty()) {
+        index = static_cast<int>(shard.transfers.size());
+        shard.transfers.push_back(transfer);
+    } else {
+        index = shard.free_transfers.back();
+        shard.free_transfers.pop_back();
+        shard.transfers[index] = transfer;
+    }
+
+    // The transfer is outstanding until its last chunk completes, so a
+    // quiet waits for chunks which are not issued yet.
+    outstanding[transfer.wg_id]++;
+    issueChunks(shard, index);
+}
+
+void
+MPITransport::issueChunks(ProgressShard &shard,
+                          int index) {
+    auto &transfer {shard.transfers[index]};
+    while (transfer.issued < transfer.size &&
+           transfer.in_flight < chunks_in_flight) {
+        auto offset {transfer.issued};
+        auto length {std::min(chunk_size, transfer.size - offset)};
+        RequestProperties properties {transfer.threadId,
+                                      transfer.wg_id,
+                                      false};
+        properties.transfer = index;
+        issueRMA(transfer.is_get,
+                 transfer.dst + offset,
+                 transfer.src + offset,
+                 length,
+                 transfer.pe,
+                 transfer.wg_id,
+                 properties);
+        transfer.issued += length;
+        transfer.in_flight++;
+    }
+}
+
+void
+MPITransport::continueTransfer(ProgressShard &shard,
+                               int index) {
+    auto &transfer {shard.transfers[index]};
+    transfer.in_flight--;
+    issueChunks(shard, index);
+    if (transfer.in_flight) {
+        return;
+    }
+
+    auto *bp {backend_proxy->get()};
+    outstanding[transfer.wg_id]--;
+    if (!transfer.is_get && !parked[transfer.wg_id].empty()) {
+        shard.resumable.push_back(transfer.wg_id);
+    }
+    if (transfer.blocking) {
+        bp->queue_descs[transfer.wg_id].status[transfer.threadId] = 1;
+        if (bp->gpu_queue) {
+            SFENCE();
+            bp->hdp_policy->hdp_flush();
+        }
+    }
+    transfer = {};
+    shard.free_transfers.push_back(index);
+}
+
+bool
+MPITransport::hasPendingPuts(int wg_id,
+                             int pe) {
+    /*
+     * Is a chunked put of the work-group to the target (any target if pe
+     * is -1) still in progress?
+     */
+    for (const auto &transfer : shardOf(wg_id).transfers) {
+        if (transfer.wg_id == wg_id &&
+            !transfer.is_get &&
+            (pe == -1 || transfer.pe == pe)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void*
+MPITransport::acquirePayload(ProgressShard &shard) {
+    auto &free_payloads {shard.free_payloads};
+    while (free_payloads.empty()) {
+        progressShard(shard);
+    }
+    auto *payload {free_payloads.back()};
+    free_payloads.pop_back();
+    return payload;
+}
+
+void
+MPITransport::releasePayload(ProgressShard &shard,
+                             void *payload) {
+    shard.free_payloads.push_back(static_cast<InlinePayload*>(payload));
 }
 
 Status
@@ -1418,37 +1911,44 @@ MPITransport::amoFCAS(void *dst,
 Status
 MPITransport::getMem(void *dst,
                      void *src,
-                     int size,
+                     size_t size,
                      int pe,
                      int wg_id,
                      int threadId,
                      bool blocking) {
-    auto *bp {backend_proxy->get()};
-
-    outstanding[wg_id]++;
+    if (size > chunk_size) {
+        startTransfer({static_cast<char*>(dst), static_cast<char*>(src), size,
+                       0, 0, pe, wg_id, threadId, blocking, true});
+        return Status::ROC_SHMEM_SUCCESS;
+    }
 
-    MPI_Request request {};
-    NET_CHECK(MPI_Rget(dst,
-                       size,
-                       MPI_CHAR,
-                       pe,
-                       bp->heap_window_info[wg_id]->get_offset(src),
-                       size,
-                       MPI_CHAR,
-                       bp->heap_window_info[wg_id]->get_win(),
-                       &request));
-
-   req_prop_vec.emplace_back(threadId, wg_id, blocking);
-   req_vec.push_back(request);
+    issueRMA(true, dst, src, size, pe, wg_id, {threadId, wg_id, blocking});
 
     return Status::ROC_SHMEM_SUCCESS;
 }
 
 Status
 MPITransport::progress() {
+    /*
+     * Each shard is owned by its progress thread, so this is only safe
+     * while those threads are not running.
+     */
+    for (auto &shard : shards) {
+        progressShard(*shard);
+        resumeParked(*shard);
+    }
+    return Status::ROC_SHMEM_SUCCESS;
+}
+
+size_t
+MPITransport::progressShard(ProgressShard &shard) {
     MPI_Status status {};
     int flag {0};
     auto *bp {backend_proxy->get()};
+    auto &req_vec {shard.req_vec};
+    auto &req_prop_vec {shard.req_prop_vec};
+    auto &test_offset {shard.test_offset};
+    auto *indices {shard.indices.data()};
 
     DPRINTF("Entering progress engine\n");
 
@@ -1465,18 +1965,27 @@ MPITransport::progress() {
         DPRINTF("Testing all outstanding requests (%zu\n)",
                 req_vec.size());
 
-        // Check completion of any outstanding requests. We check on either
-        // the first INDICES_SIZE requests or the size of the request vector
+        // Check completion of a window of up to INDICES_SIZE requests. The
+        // window rotates over the whole table so requests behind a slow
+        // head are tested too.
         auto req_vec_size {static_cast<int>(req_vec.size())};
-        int incount {(req_vec_size < INDICES_SIZE) ?
-                     req_vec_size :
-                     INDICES_SIZE};
+        if (test_offset >= req_vec_size) {
+            test_offset = 0;
+        }
+        int incount {std::min(req_vec_size - test_offset, INDICES_SIZE)};
         int outcount {};
         NET_CHECK(MPI_Testsome(incount,
-                               req_vec.data(),
+                               req_vec.data() + test_offset,
                                &outcount,
                                indices,
                                MPI_STATUSES_IGNORE));
+        if (outcount == MPI_UNDEFINED) {
+            outcount = 0;
+        }
+        for (int i {0}; i < outcount; i++) {
+            indices[i] += test_offset;
+        }
+        test_offset += incount;
 
         // If any request completed remove it from outstanding request vector
         for (int i {0}; i < outcount; i++) {
@@ -1505,12 +2014,20 @@ MPITransport::progress() {
             }
 
             if (req_prop_vec[indx].inline_data) {
-                free(req_prop_vec[indx].src);
+                releasePayload(shard, req_prop_vec[indx].src);
+            }
+
+            // Issuing the next chunk appends to req_vec, which leaves the
+            // indices of this round's completions valid.
+            if (req_prop_vec[indx].transfer != -1) {
+                continueTransfer(shard, req_prop_vec[indx].transfer);
             }
 
             // If the GPU has requested a quiet, notify it of completion when
             // all outstanding requests are complete.
-            if (!outstanding[wg_id] && !waiting_quiet[wg_id].empty()) {
+            if (wg_id != -1 &&
+                !outstanding[wg_id] &&
+                !waiting_quiet[wg_id].empty()) {
                 for (const auto threadId : waiting_quiet[wg_id]) {
                     DPRINTF("Finished Quiet for wg_id %d at threadId %d\n",
                             wg_id, threadId);
@@ -1526,16 +2043,20 @@ MPITransport::progress() {
             }
         }
 
-        // Remove the MPI Request and the RequestProperty tracking entry
-        sort(indices, indices + outcount, std::greater<int>());
+        // Remove the MPI Request and the RequestProperty tracking entry by
+        // moving the last entry into their slot. Going from the highest
+        // index down, the last entry is never one which completed.
+        std::sort(indices, indices + outcount, std::greater<int>());
         for (int i {0}; i < outcount; i++) {
             int indx {indices[i]};
-            req_vec.erase(req_vec.begin() + indx);
-            req_prop_vec.erase(req_prop_vec.begin() + indx);
+            req_vec[indx] = req_vec.back();
+            req_vec.pop_back();
+            req_prop_vec[indx] = req_prop_vec.back();
+            req_prop_vec.pop_back();
         }
+        return static_cast<size_t>(outcount);
     }
-
-    return Status::ROC_SHMEM_SUCCESS;
+    return 0;
 }
 
 Status
@@ -1554,7 +2075,12 @@ MPITransport::quiet(int wg_id, int threadId) {
 
 int
 MPITransport::numOutstandingRequests() {
-    return req_vec.size() + q.size();
+    size_t count {0};
+    for (auto &shard : shards) {
+        count += shard->req_vec.size() + shard->request_ring->size() +
+                 shard->num_parked;
+    }
+    return count;
 }
 
 }  // namespace rocshmem
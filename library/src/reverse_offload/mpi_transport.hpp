@@ -23,11 +23,17 @@
 #ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_MPI_TRANSPORT_HPP
 #define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_MPI_TRANSPORT_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <thread>
 #include <vector>
 
+#include "progress_policy.hpp"
+#include "request_ring.hpp"
 #include "transport.hpp"
 
 namespace rocshmem {
@@ -240,7 +246,7 @@ class MPITransport : public Transport {
     Status
     putMem(void *dst,
            void *src,
-           int size,
+           size_t size,
            int pe,
            int wg_id,
            int threadId,
@@ -270,7 +276,7 @@ class MPITransport : public Transport {
     Status
     getMem(void *dst,
            void *src,
-           int size,
+           size_t size,
            int pe,
            int wg_id,
            int threadId,
@@ -286,13 +292,21 @@ class MPITransport : public Transport {
     virtual int
     numOutstandingRequests() override;
 
-    virtual void
+    virtual bool
     insertRequest(const queue_element_t *element,
+                  const queue_element_ext_t *ext,
+                  const char *payload,
                   int queue_id) override;
 
+    /**
+     * @brief Wake the progress threads if they are blocked waiting for work.
+     */
+    void
+    wakeProgressThreads();
+
     virtual bool
     readyForFinalize() override {
-        return !transport_up;
+        return !running_threads;
     }
 
     MPI_Comm ro_net_comm_world {};
@@ -365,6 +379,103 @@ class MPITransport : public Transport {
         bool blocking {};
         void *src {nullptr};
         bool inline_data {};
+        // Index of the chunked transfer the request is a chunk of, or -1.
+        int transfer {-1};
+    };
+
+    // A put or get larger than the chunk size. At most chunks_in_flight
+    // of its chunks are issued at once; each completion issues the next
+    // one, so requests of other work-groups are not held behind it.
+    struct ChunkedTransfer
+    {
+        char *dst {nullptr};
+        char *src {nullptr};
+        size_t size {0};
+        // Bytes covered by chunks issued so far.
+        size_t issued {0};
+        int in_flight {0};
+        int pe {-1};
+        // -1 while the entry is unused.
+        int wg_id {-1};
+        int threadId {-1};
+        bool blocking {};
+        bool is_get {};
+    };
+
+    // A device command copied out by a poller thread. The extension is
+    // only filled in when the header has one and the payload only for
+    // inline puts; no command has both.
+    struct QueuedRequest
+    {
+        queue_element_t element {};
+        union {
+            queue_element_ext_t ext {};
+            char payload[RO_NET_INLINE_PUT_MAX_BYTES];
+        };
+        int queue_idx {-1};
+    };
+
+    // Staging buffer for the value of an inline put (RO_NET_P or an
+    // inline RO_NET_PUT), aligned enough for any scalar type.
+    struct alignas(alignof(std::max_align_t)) InlinePayload
+    {
+        char data[RO_NET_INLINE_PUT_MAX_BYTES];
+    };
+
+    // State of one progress thread. Work-groups are sharded over the
+    // progress threads by wg_id, and everything a request touches from
+    // submission to completion lives in the shard of its work-group, so
+    // the threads share no mutable state on the request path.
+    struct ProgressShard
+    {
+        // Handoff from the poller threads to this progress thread.
+        std::unique_ptr<RequestRing<QueuedRequest>> request_ring {nullptr};
+
+        // Elements popped from request_ring in one progress iteration.
+        std::vector<QueuedRequest> submit_batch {};
+
+        // Issue order of a run of RMA elements in submit_batch.
+        std::vector<size_t> submit_order {};
+
+        // Number of elements to pop in the next progress iteration.
+        size_t submit_batch_size {MIN_SUBMIT_BATCH_SIZE};
+
+        // Unordered table of in-flight MPI Requests. Can complete out of
+        // order. Completed entries are swap-removed, so req_vec stays
+        // dense for MPI_Testsome and each completion costs O(1).
+        std::vector<RequestProperties> req_prop_vec {};
+
+        std::vector<MPI_Request> req_vec {};
+
+        // First entry of req_vec tested by the next progress call.
+        int test_offset {0};
+
+        // Indices of the requests completed by one MPI_Testsome.
+        std::vector<int> indices {};
+
+        // Fixed pool of payload slots; free_payloads is a LIFO of unused
+        // ones so recently released (cache-warm) slots are reused first.
+        std::vector<InlinePayload> payload_pool {};
+
+        std::vector<InlinePayload*> free_payloads {};
+
+        // Large puts and gets in progress; free_transfers holds the
+        // indices of unused entries.
+        std::vector<ChunkedTransfer> transfers {};
+
+        std::vector<int> free_transfers {};
+
+        // Work-groups whose parked requests may be able to go ahead
+        // since one of their chunked puts completed.
+        std::vector<int> resumable {};
+
+        // Requests held in parked by the work-groups of this shard.
+        size_t num_parked {0};
+
+        // Wakes the progress thread when the pollers hand it work.
+        Doorbell work_doorbell {};
+
+        std::thread thread {};
     };
 
     MPI_Comm
@@ -372,40 +483,140 @@ class MPITransport : public Transport {
                int logPstride,
                int size);
 
+    ProgressShard&
+    shardOf(int wg_id);
+
+    void
+    trackRequest(MPI_Request request,
+                 const RequestProperties &properties);
+
+    void
+    threadProgressEngine(ProgressShard *shard);
+
+    size_t
+    submitRequestsToMPI(ProgressShard &shard);
+
+    void
+    submitRMAGroup(ProgressShard &shard,
+                   size_t begin,
+                   size_t end);
+
+    void
+    submitRequest(const queue_element_t *next_element,
+                  const queue_element_ext_t *next_ext,
+                  const char *payload,
+                  int queue_idx);
+
+    void
+    dispatchRequest(const queue_element_t *next_element,
+                    const queue_element_ext_t *next_ext,
+                    const char *payload,
+                    int queue_idx);
+
+    bool
+    waitsForTransfers(const queue_element_t &element,
+                      int wg_id);
+
+    size_t
+    resumeParked(ProgressShard &shard);
+
+    size_t
+    progressShard(ProgressShard &shard);
+
+    void
+    issueRMA(bool is_get,
+             void *dst,
+             void *src,
+             size_t size,
+             int pe,
+             int wg_id,
+             const RequestProperties &properties);
+
+    void
+    startTransfer(const ChunkedTransfer &transfer);
+
+    void
+    issueChunks(ProgressShard &shard,
+                int index);
+
+    void
+    continueTransfer(ProgressShard &shard,
+                     int index);
+
+    bool
+    hasPendingPuts(int wg_id,
+                   int pe);
+
+    void*
+    acquirePayload(ProgressShard &shard);
+
+    void
+    releasePayload(ProgressShard &shard,
+                   void *payload);
+
+    void
+    markDirty(int wg_id,
+              int pe);
+
     void
-    threadProgressEngine();
+    flushTarget(int wg_id,
+                int pe);
 
     void
-    submitRequestsToMPI();
+    flushDirty(int wg_id);
 
-    // Unordered vector of in-flight MPI Requests. Can complete out of order.
-    std::vector<RequestProperties> req_prop_vec {};
+    std::vector<std::unique_ptr<ProgressShard>> shards {};
 
-    std::vector<MPI_Request> req_vec {};
+    static constexpr size_t REQUEST_TABLE_RESERVE {4096};
 
     std::vector<std::vector<int> > waiting_quiet {};
 
     std::vector<int> outstanding {};
 
+    // Collectives of different shards may create communicators at once.
+    std::mutex comm_map_mutex {};
+
     std::map<CommKey, MPI_Comm> comm_map {};
 
-    std::queue<const queue_element_t *> q {};
+    // Requests of each work-group held back, in arrival order, until
+    // the chunked puts they must observe have completed. Parking them
+    // instead of flushing all chunks at once keeps the progress thread
+    // serving other work-groups meanwhile.
+    std::vector<std::deque<QueuedRequest> > parked {};
 
-    std::queue<int> q_wgid {};
+    // Targets of each work-group with puts which are not flushed yet.
+    std::vector<std::vector<int> > dirty_pes {};
 
-    std::mutex queue_mutex {};
+    // Membership of dirty_pes indexed by wg_id * num_pes + pe. Bytes
+    // rather than bits since shards update entries of different
+    // work-groups concurrently.
+    std::vector<char> is_dirty {};
 
-    volatile int hostBarrierDone {false};
+    // Do the progress threads block when idle (RO_NET_PROGRESS_POLICY)?
+    bool progress_sleeps {false};
 
-    volatile bool transport_up {false};
+    // Puts and gets larger than this are split into chunks
+    // (RO_NET_RMA_CHUNK_SIZE, at least RO_NET_INLINE_PUT_MAX_BYTES).
+    size_t chunk_size {size_t{1} << 20};
 
-    BackendProxyT *backend_proxy {nullptr};
+    // Chunks of one transfer issued at once (RO_NET_RMA_CHUNKS_IN_FLIGHT).
+    int chunks_in_flight {4};
+
+    // Keeps every chunk within the int count of MPI_Rput and MPI_Rget.
+    static constexpr size_t MAX_CHUNK_SIZE {size_t{1} << 30};
+
+    static constexpr size_t MIN_SUBMIT_BATCH_SIZE {8};
 
-    std::thread *progress_thread {nullptr};
+    static constexpr size_t MAX_SUBMIT_BATCH_SIZE {256};
 
-    int *indices {nullptr};
+    volatile int hostBarrierDone {false};
+
+    // Number of progress threads which are running.
+    std::atomic<int> running_threads {0};
+
+    BackendProxyT *backend_proxy {nullptr};
 
-    const int INDICES_SIZE {128};
+    static constexpr int INDICES_SIZE {128};
 };
 
 }  // namespace rocshmem
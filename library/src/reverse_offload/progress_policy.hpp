@@ -0,0 +1,250 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_PROGRESS_POLICY_HPP
+#define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_PROGRESS_POLICY_HPP
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <immintrin.h>
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+/**
+ * @file progress_policy.hpp
+ *
+ * @brief Contains the idle policy of the RO host threads
+ *
+ * The queue pollers and the transport's progress thread run for the whole
+ * job. A thread which finds no work first spins with pauses which double
+ * on each idle pass, so bursts are picked up with no added latency. Once
+ * the spins are exhausted the policy decides what happens next: keep
+ * spinning, yield the processor, or block until woken (or until a bounded
+ * timeout expires, so a missed wakeup only costs latency).
+ */
+
+namespace rocshmem {
+
+enum class ProgressMode {
+    SPIN,
+    YIELD,
+    SLEEP,
+};
+
+struct ProgressPolicy {
+    /**
+     * @brief What an idle thread does after its spins are exhausted
+     */
+    ProgressMode mode {ProgressMode::SPIN};
+
+    /**
+     * @brief Longest a sleeping thread blocks before it checks for work
+     */
+    std::chrono::microseconds max_sleep {1000};
+
+    /**
+     * @brief Read the policy from RO_NET_PROGRESS_POLICY ("spin", "yield"
+     * or "sleep") and RO_NET_PROGRESS_SLEEP_US.
+     *
+     * @return The policy; unset or unknown values keep the defaults
+     */
+    static ProgressPolicy
+    from_env() {
+        ProgressPolicy policy {};
+        if (const char *value = getenv("RO_NET_PROGRESS_POLICY")) {
+            if (!strcmp(value, "spin")) {
+                policy.mode = ProgressMode::SPIN;
+            } else if (!strcmp(value, "yield")) {
+                policy.mode = ProgressMode::YIELD;
+            } else if (!strcmp(value, "sleep")) {
+                policy.mode = ProgressMode::SLEEP;
+            }
+        }
+        if (const char *value = getenv("RO_NET_PROGRESS_SLEEP_US")) {
+            auto sleep_us {atol(value)};
+            if (sleep_us > 0) {
+                policy.max_sleep = std::chrono::microseconds{sleep_us};
+            }
+        }
+        return policy;
+    }
+};
+
+/**
+ * @brief Per-thread state of the idle policy
+ */
+class IdleBackoff {
+  public:
+    /**
+     * @brief Primary constructor
+     *
+     * @param[in] Policy applied once the spins are exhausted
+     */
+    explicit IdleBackoff(ProgressMode mode)
+        : mode_{mode} {
+    }
+
+    /**
+     * @brief Called after a pass which found work
+     */
+    void
+    reset() {
+        idle_passes_ = 0;
+    }
+
+    /**
+     * @brief Called after a pass which found no work
+     *
+     * Pauses for a number of iterations which doubles with each idle
+     * pass. Once the cap is reached, keeps pausing, yields, or asks the
+     * caller to block, depending on the mode.
+     *
+     * @return True if the caller should block until woken
+     */
+    bool
+    idle() {
+        if (idle_passes_ < MAX_SPIN_PASSES) {
+            spin(idle_passes_++);
+            return false;
+        }
+        switch (mode_) {
+            case ProgressMode::SPIN:
+                spin(MAX_SPIN_PASSES);
+                return false;
+            case ProgressMode::YIELD:
+                std::this_thread::yield();
+                return false;
+            default:
+                return true;
+        }
+    }
+
+  private:
+    static void
+    spin(int exponent) {
+        for (int i {0}; i < (1 << exponent); i++) {
+            _mm_pause();
+        }
+    }
+
+    /**
+     * @brief Idle passes which pause before the mode takes over
+     */
+    static constexpr int MAX_SPIN_PASSES {10};
+
+    ProgressMode mode_ {ProgressMode::YIELD};
+
+    int idle_passes_ {0};
+};
+
+/**
+ * @brief Futex-backed wakeup between host threads
+ *
+ * A waiter arms the doorbell, checks for work once more, and then waits
+ * on the ticket returned by arm. A producer publishes its work and then
+ * rings; the ring only makes a system call while a waiter is armed.
+ */
+class Doorbell {
+  public:
+    /**
+     * @brief Announce that the caller is about to wait
+     *
+     * @return Ticket to pass to wait
+     */
+    uint32_t
+    arm() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        return sequence_.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Withdraw an arm without waiting
+     */
+    void
+    disarm() {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Block until rung after arm or until the timeout expires
+     *
+     * @param[in] Ticket returned by arm
+     * @param[in] Longest time to block
+     */
+    void
+    wait(uint32_t ticket,
+         std::chrono::microseconds timeout) {
+        auto seconds {std::chrono::duration_cast<std::chrono::seconds>(
+                          timeout)};
+        auto nanoseconds {std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              timeout - seconds)};
+        timespec ts {static_cast<time_t>(seconds.count()),
+                     static_cast<long>(nanoseconds.count())};
+        if (sequence_.load(std::memory_order_acquire) == ticket) {
+            syscall(SYS_futex,
+                    reinterpret_cast<uint32_t*>(&sequence_),
+                    FUTEX_WAIT_PRIVATE,
+                    ticket,
+                    &ts,
+                    nullptr,
+                    0);
+        }
+        disarm();
+    }
+
+    /**
+     * @brief Wake every armed waiter
+     *
+     * @note Must follow the publication of the work it announces.
+     */
+    void
+    ring() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed)) {
+            sequence_.fetch_add(1, std::memory_order_release);
+            syscall(SYS_futex,
+                    reinterpret_cast<uint32_t*>(&sequence_),
+                    FUTEX_WAKE_PRIVATE,
+                    INT_MAX,
+                    nullptr,
+                    nullptr,
+                    0);
+        }
+    }
+
+  private:
+    std::atomic<uint32_t> sequence_ {0};
+
+    std::atomic<int> waiters_ {0};
+};
+
+}  // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_PROGRESS_POLICY_HPP
@@ -30,14 +30,22 @@ namespace rocshmem {
 
 template <typename ALLOCATOR>
 class QueueElementProxy {
-    using ProxyT = DeviceProxy<ALLOCATOR, queue_element_t>;
+    /*
+     * A header slot followed by room for its extension slot or the
+     * gathered payload of an inline put.
+     */
+    static constexpr size_t NUM_SLOTS {1 + RO_NET_INLINE_MAX_SLOTS};
+
+    using ProxyT = DeviceProxy<ALLOCATOR, queue_element_t, NUM_SLOTS>;
 
   public:
     /*
      * Placement new the memory which is allocated by proxy_
      */
     QueueElementProxy() {
-        new (proxy_.get()) queue_element_t();
+        for (size_t i {0}; i < NUM_SLOTS; i++) {
+            new (proxy_.get() + i) queue_element_t();
+        }
     }
 
     /*
@@ -45,7 +53,9 @@ class QueueElementProxy {
      * delete must be called manually.
      */
     ~QueueElementProxy() {
-        proxy_.get()->~queue_element_t();
+        for (size_t i {0}; i < NUM_SLOTS; i++) {
+            proxy_.get()[i].~queue_element_t();
+        }
     }
 
     /*
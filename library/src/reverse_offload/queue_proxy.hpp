@@ -25,6 +25,7 @@
 
 #include "ro_net_internal.hpp"
 #include "device_proxy.hpp"
+#include "thread_placement.hpp"
 
 namespace rocshmem {
 
@@ -75,7 +76,7 @@ class QueueProxy {
     ProxyPerBlockT per_block_queue_proxy_ {};
 };
 
-using QueueProxyT = QueueProxy<HIPHostAllocator>;
+using QueueProxyT = QueueProxy<HIPHostLocalAllocator>;
 
 }  // namespace rocshmem
 
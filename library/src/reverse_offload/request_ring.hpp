@@ -0,0 +1,187 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+
+#ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_REQUEST_RING_HPP
+#define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_REQUEST_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @file request_ring.hpp
+ *
+ * @brief Contains a bounded multi-producer single-consumer ring
+ *
+ * The ring hands device requests from the queue poller threads to the
+ * transport's progress thread. Its slots are allocated once, so a
+ * handoff costs one copy into the ring and one copy out of it; there is
+ * no heap allocation and no lock.
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue). A
+ * producer claims a position with a compare-and-swap on the tail and
+ * publishes the slot by bumping its sequence. The consumer takes
+ * published slots in order and releases them to the producers of the
+ * next lap by bumping the sequence again. Slots and both indices sit on
+ * separate cache lines.
+ */
+
+namespace rocshmem {
+
+template <typename T>
+class RequestRing {
+  public:
+    /**
+     * @brief Primary constructor
+     *
+     * @param[in] Minimum number of slots; rounded up to a power of two
+     */
+    explicit RequestRing(size_t min_capacity) {
+        size_t capacity {2};
+        while (capacity < min_capacity) {
+            capacity <<= 1;
+        }
+        mask_ = capacity - 1;
+        slots_ = std::make_unique<Slot[]>(capacity);
+        for (size_t i {0}; i < capacity; i++) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Copy a value into the ring
+     *
+     * May be called concurrently by any number of threads.
+     *
+     * @param[in] Value to copy
+     *
+     * @return False if the ring is full
+     */
+    bool
+    push(const T& value) {
+        auto pos {tail_.load(std::memory_order_relaxed)};
+        Slot* slot {nullptr};
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            auto sequence {slot->sequence.load(std::memory_order_acquire)};
+            auto diff {static_cast<intptr_t>(sequence) -
+                       static_cast<intptr_t>(pos)};
+            if (!diff) {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = value;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy up to max values out of the ring in push order
+     *
+     * Only one thread may pop from a ring.
+     *
+     * @param[out] Array of at least max values
+     * @param[in] Maximum number of values to pop
+     *
+     * @return Number of values popped
+     */
+    size_t
+    pop(T* values, size_t max) {
+        auto head {head_.load(std::memory_order_relaxed)};
+        size_t count {0};
+        while (count < max) {
+            auto& slot {slots_[head & mask_]};
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            values[count++] = slot.value;
+            slot.sequence.store(head + mask_ + 1, std::memory_order_release);
+            head++;
+        }
+        head_.store(head, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Accessor for the number of values in the ring
+     *
+     * @return Approximate count if producers or the consumer are active
+     */
+    size_t
+    size() const {
+        auto tail {tail_.load(std::memory_order_relaxed)};
+        auto head {head_.load(std::memory_order_relaxed)};
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief Accessor for the number of slots
+     *
+     * @return Capacity of the ring
+     */
+    size_t
+    capacity() const {
+        return mask_ + 1;
+    }
+
+  private:
+    /**
+     * @brief A value and the sequence number which owns it
+     */
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence {0};
+        T value {};
+    };
+
+    /**
+     * @brief Storage for the values
+     */
+    std::unique_ptr<Slot[]> slots_ {nullptr};
+
+    /**
+     * @brief Number of slots minus one
+     */
+    size_t mask_ {0};
+
+    /**
+     * @brief Next position claimed by producers
+     */
+    alignas(64) std::atomic<size_t> tail_ {0};
+
+    /**
+     * @brief Next position taken by the consumer
+     */
+    alignas(64) std::atomic<size_t> head_ {0};
+};
+
+}  // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_REQUEST_RING_HPP
@@ -35,7 +35,33 @@
 
 namespace rocshmem {
 
-#define DEFAULT_QUEUE_SIZE 64
+#define DEFAULT_QUEUE_SIZE 128
+
+/*
+ * Small non-blocking puts from a work-group to one PE are held back and
+ * sent as a single RO_NET_PUT_BATCH command of up to RO_NET_BATCH_MAX_OPS
+ * puts or RO_NET_BATCH_MAX_BYTES bytes.
+ */
+#define RO_NET_BATCH_MAX_OPS 16
+#define RO_NET_BATCH_MAX_OP_BYTES 512
+#define RO_NET_BATCH_MAX_BYTES 4096
+#define RO_NET_BATCH_OPS_PER_SLOT 2
+
+/*
+ * Puts of up to RO_NET_INLINE_PUT_MAX_BYTES bytes carry their payload in
+ * the queue, RO_NET_INLINE_BYTES_PER_SLOT bytes per slot after the header.
+ */
+#define RO_NET_INLINE_PUT_MAX_BYTES 240
+#define RO_NET_INLINE_BYTES_PER_SLOT 60
+#define RO_NET_INLINE_MAX_SLOTS \
+    ((RO_NET_INLINE_PUT_MAX_BYTES + RO_NET_INLINE_BYTES_PER_SLOT - 1) / \
+     RO_NET_INLINE_BYTES_PER_SLOT)
+
+/*
+ * Most slots a single command takes: a full batch.
+ */
+#define RO_NET_MAX_CMD_SLOTS \
+    (1 + RO_NET_BATCH_MAX_OPS / RO_NET_BATCH_OPS_PER_SLOT)
 
 #define SFENCE()   asm volatile("sfence" ::: "memory")
 
@@ -58,6 +84,9 @@ enum ro_net_cmds {
     RO_NET_TEAM_BROADCAST,
     RO_NET_ALLTOALL,
     RO_NET_FCOLLECT,
+    RO_NET_PUT_BATCH,
+    RO_NET_PUT_INLINE,
+    RO_NET_PUT_NBI_INLINE,
 };
 
 enum ro_net_types {
@@ -95,40 +124,112 @@ enum RO_NET_Op {
     RO_NET_SUM,
 };
 
+/*
+ * Device queues are rings of 64-byte slots. A command is a header slot,
+ * which carries everything RMA and AMO commands need, followed by
+ * num_ext extension slots for the fields of collectives.
+ *
+ * Every slot starts with the sequence number of its position in the
+ * ring: one more than the low 32 bits of the absolute write index. The
+ * GPU writes it last, so the CPU knows a command is ready when the header
+ * at its read index carries the expected number. Slots left from earlier
+ * laps carry older numbers, so the CPU never has to clear a slot.
+ */
 typedef struct queue_element {
-    // Polled by the CPU to determine when a command is ready.  Set by the GPU
-    // once a queue element has been completely filled out.  This is padded
-    // from the actual data to prevent thrashing on an APU when the GPU is
-    // trying to fill out a packet and the CPU is reading the valid bit.
-    volatile char valid;
-    char padding[63];
+    // Polled by the CPU to determine when a command is ready.
+    volatile uint32_t seq;
     // All fields written by the GPU and read by the CPU
-    ro_net_cmds  type;
+    uint8_t type;
+    uint8_t num_ext;
+    uint8_t op;
+    uint8_t datatype;
     int     PE;
-    int     size;
+    int     threadId;
+    int64_t size;
     void*   src;
     void*   dst;
-    int     threadId;
+    // Comparison operand of RO_NET_AMO_FCAS
+    int64_t cond;
+} __attribute__((__aligned__(64))) queue_element_t;
+
+typedef struct queue_element_ext {
+    // Sequence number of the slot; never polled.
+    volatile uint32_t seq;
     // For collectives
     int logPE_stride;
     int PE_size;
+    int PE_root;
     void*  pWrk;
     long*  pSync;
-    int  op;
-    int  datatype;
-    int PE_root;
     MPI_Comm team_comm;
-} __attribute__((__aligned__(64))) queue_element_t;
+} __attribute__((__aligned__(64))) queue_element_ext_t;
+
+/*
+ * Extension slot of RO_NET_PUT_BATCH; the header's size field holds the
+ * number of puts and its PE field their target.
+ */
+typedef struct queue_element_batch {
+    // Sequence number of the slot; never polled.
+    volatile uint32_t seq;
+    int    size[RO_NET_BATCH_OPS_PER_SLOT];
+    void*  dst[RO_NET_BATCH_OPS_PER_SLOT];
+    void*  src[RO_NET_BATCH_OPS_PER_SLOT];
+} __attribute__((__aligned__(64))) queue_element_batch_t;
+
+/*
+ * Payload slot of RO_NET_PUT_INLINE and RO_NET_PUT_NBI_INLINE; the
+ * header's size field holds the payload size.
+ */
+typedef struct queue_element_payload {
+    // Sequence number of the slot; never polled.
+    volatile uint32_t seq;
+    char   data[RO_NET_INLINE_BYTES_PER_SLOT];
+} __attribute__((__aligned__(64))) queue_element_payload_t;
+
+static_assert(sizeof(queue_element_t) == 64,
+              "queue header must fill one slot");
+static_assert(sizeof(queue_element_ext_t) == sizeof(queue_element_t),
+              "queue extension must fill one slot");
+static_assert(sizeof(queue_element_batch_t) == sizeof(queue_element_t),
+              "queue batch extension must fill one slot");
+static_assert(sizeof(queue_element_payload_t) == sizeof(queue_element_t),
+              "queue payload must fill one slot");
+static_assert(1 + RO_NET_INLINE_MAX_SLOTS <= RO_NET_MAX_CMD_SLOTS,
+              "an inline put must not be the longest command");
+
+/*
+ * Sequence number which marks the slot at an absolute queue index as
+ * written.
+ */
+__host__ __device__ inline uint32_t
+queue_slot_seq(uint64_t index) {
+    return static_cast<uint32_t>(index) + 1;
+}
+
+__host__ __device__ inline bool
+is_inline_put(uint8_t type) {
+    return type == RO_NET_PUT_INLINE || type == RO_NET_PUT_NBI_INLINE;
+}
+
+/*
+ * Number of payload slots behind the header of an inline put.
+ */
+__host__ __device__ inline uint64_t
+inline_put_slots(uint64_t size) {
+    return (size + RO_NET_INLINE_BYTES_PER_SLOT - 1) /
+           RO_NET_INLINE_BYTES_PER_SLOT;
+}
 
 typedef struct queue_desc {
-    // Read index for the queue.  Rarely read by the GPU when it thinks the
-    // queue might be full, but the GPU normally uses a local copy that lags
-    // behind the true read_idx.
+    // Read index for the queue.  Published by the CPU once per drain, so
+    // it can lag behind the element the CPU is working on.  The GPU keeps
+    // a local copy and only reads this one when the local copy leaves no
+    // room for a reservation.
     uint64_t read_idx;
     char padding1[56];
     // Write index for the queue.  Never accessed by CPU, since it uses the
-    // valid bit in the packet itself to determine whether there is data to
-    // consume.  The GPU has a local copy of the write_idx that it uses, but it
+    // sequence number in the packet header to determine whether there is
+    // data to consume.  The GPU has a local copy of the write_idx that it uses, but it
     // does write the local index to this location when the kernel completes
     // in case the queue needs to be reused without reseting all the pointers
     // to zero.
@@ -160,6 +261,17 @@ typedef Stats<RO_NUM_STATS> ROStats;
 typedef NullStats<RO_NUM_STATS> ROStats;
 #endif
 
+/* Puts of a work-group waiting to be sent as one batch */
+struct ro_net_put_batch {
+    int lock;
+    int count;
+    int pe;
+    int bytes;
+    int size[RO_NET_BATCH_MAX_OPS];
+    void *dst[RO_NET_BATCH_MAX_OPS];
+    void *src[RO_NET_BATCH_MAX_OPS];
+};
+
 /* Meant for local allocation on the GPU */
 struct ro_net_wg_handle {
     queue_element_t *queue;
@@ -168,24 +280,61 @@ struct ro_net_wg_handle {
     uint64_t read_idx;
     uint64_t write_idx;
     uint64_t *host_read_idx;
+    uint64_t *activity_word;
+    uint64_t activity_mask;
+    unsigned int *sleeping_pollers;
+    hsa_signal_t poller_signal;
     uint64_t queue_size;
     char *status;
     char *g_ret;
     atomic_ret_t atomic_ret;
     IpcImpl ipcImpl;
     HdpPolicy hdp_policy;
+    bool put_batch_enabled;
+    bool put_inline_enabled;
+    ro_net_put_batch put_batch;
 };
 
 /* Device-side internal functions */
+
+/* Provided by the ROCm device libraries; raises the signal's interrupt */
+extern "C" __device__ void
+__ockl_hsa_signal_add(hsa_signal_t sig,
+                      long value,
+                      int mem_order);
+
 __device__ void inline
 __ro_inv() {
     asm volatile ("buffer_wbinvl1;");
 }
 
+/*
+ * Add a non-blocking put to the work-group's batch.
+ *
+ * Returns false, without queueing anything, if batching is disabled or
+ * the put is too large; the caller then sends it on its own.
+ */
 __device__ bool
-isFull(uint64_t read_idx,
-       uint64_t write_idx,
-       int queue_size);
+batch_put(void *dst,
+          const void *src,
+          size_t size,
+          int pe,
+          struct ro_net_wg_handle *handle);
+
+/*
+ * Command type for a put of size bytes: the inline variant when the
+ * payload fits in the queue and inline puts are enabled.
+ */
+__device__ ro_net_cmds
+put_cmd(size_t size,
+        bool blocking,
+        struct ro_net_wg_handle *handle);
+
+/*
+ * Send the work-group's batched puts, if any.
+ */
+__device__ void
+flush_put_batch(struct ro_net_wg_handle *handle);
 
 __device__ void
 build_queue_element(ro_net_cmds type,
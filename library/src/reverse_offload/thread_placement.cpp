@@ -0,0 +1,209 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#include "thread_placement.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace rocshmem {
+
+/*
+ * Directory of the current HIP device in sysfs; empty if unknown.
+ */
+static std::string
+gpu_sysfs_dir() {
+    int device {0};
+    if (hipGetDevice(&device) != hipSuccess) {
+        return {};
+    }
+    char bus_id[64] {};
+    if (hipDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != hipSuccess) {
+        return {};
+    }
+    std::string id {bus_id};
+    std::transform(id.begin(), id.end(), id.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    return "/sys/bus/pci/devices/" + id + "/";
+}
+
+static std::string
+read_sysfs_line(const std::string &path) {
+    std::ifstream file {path};
+    std::string line {};
+    std::getline(file, line);
+    return line;
+}
+
+std::vector<int>
+parse_cpu_list(const std::string &list) {
+    std::vector<int> cpus {};
+    std::stringstream sstream {list};
+    std::string range {};
+    while (std::getline(sstream, range, ',')) {
+        int first {-1};
+        int last {-1};
+        char dash {0};
+        char trailing {0};
+        auto fields {sscanf(range.c_str(), " %d %c %d %c",
+                            &first, &dash, &last, &trailing)};
+        if (fields == 1) {
+            last = first;
+        } else if (fields != 3 || dash != '-') {
+            return {};
+        }
+        if (first < 0 || last < first) {
+            return {};
+        }
+        for (int cpu {first}; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+int
+gpu_numa_node() {
+    auto dir {gpu_sysfs_dir()};
+    if (dir.empty()) {
+        return -1;
+    }
+    auto node {read_sysfs_line(dir + "numa_node")};
+    return node.empty() ? -1 : atoi(node.c_str());
+}
+
+std::vector<int>
+gpu_local_cpus() {
+    auto dir {gpu_sysfs_dir()};
+    if (dir.empty()) {
+        return {};
+    }
+    return parse_cpu_list(read_sysfs_line(dir + "local_cpulist"));
+}
+
+ThreadPlacement
+ThreadPlacement::from_env(const char *name) {
+    ThreadPlacement placement {};
+    const char *value {getenv(name)};
+    if (!value) {
+        return placement;
+    }
+    if (!strcmp(value, "auto")) {
+        placement.cpus = gpu_local_cpus();
+        if (placement.cpus.empty()) {
+            fprintf(stderr, "Warning: unable to find the CPUs local to the "
+                    "GPU, ignoring %s\n", name);
+        }
+    } else {
+        placement.cpus = parse_cpu_list(value);
+        placement.one_cpu_per_thread = true;
+        if (placement.cpus.empty()) {
+            fprintf(stderr, "Warning: ignoring malformed %s \"%s\"\n",
+                    name, value);
+        }
+    }
+    placement.cpus.erase(std::remove_if(placement.cpus.begin(),
+                                        placement.cpus.end(),
+                                        [](int cpu) {
+                                            return cpu >= CPU_SETSIZE;
+                                        }),
+                         placement.cpus.end());
+    return placement;
+}
+
+void
+ThreadPlacement::apply(std::thread &thread, size_t index) const {
+    if (cpus.empty()) {
+        return;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (one_cpu_per_thread) {
+        CPU_SET(cpus[index % cpus.size()], &cpu_set);
+    } else {
+        for (auto cpu : cpus) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    auto ret {pthread_setaffinity_np(thread.native_handle(),
+                                     sizeof(cpu_set),
+                                     &cpu_set)};
+    if (ret) {
+        fprintf(stderr, "Warning: unable to set the affinity of an RO "
+                "thread: %s\n", strerror(ret));
+    }
+}
+
+void
+HIPHostLocalAllocator::allocate(void** ptr, size_t size) {
+    auto node {gpu_numa_node()};
+    if (node < 0) {
+        MemoryAllocator::allocate(ptr, size);
+        return;
+    }
+
+    /*
+     * get_mempolicy fails unless the mask covers every possible node.
+     */
+    constexpr size_t bits {sizeof(unsigned long) * CHAR_BIT};
+    constexpr size_t max_nodes {1024};
+    std::vector<unsigned long> old_mask(max_nodes / bits, 0);
+    int old_mode {MPOL_DEFAULT};
+    auto saved {!syscall(SYS_get_mempolicy, &old_mode, old_mask.data(),
+                         max_nodes, nullptr, 0)};
+
+    /*
+     * Prefer rather than bind so a full node falls back to another one.
+     * The kernel reads one bit fewer than maxnode.
+     */
+    auto node_bit {static_cast<size_t>(node)};
+    std::vector<unsigned long> node_mask(node_bit / bits + 1, 0);
+    node_mask[node_bit / bits] |= 1UL << (node_bit % bits);
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, node_mask.data(),
+                node_mask.size() * bits + 1)) {
+        fprintf(stderr, "Warning: unable to place RO queues on NUMA node "
+                "%d: %s\n", node, strerror(errno));
+    }
+
+    MemoryAllocator::allocate(ptr, size);
+
+    if (saved && old_mode != MPOL_DEFAULT) {
+        syscall(SYS_set_mempolicy, old_mode, old_mask.data(), max_nodes + 1);
+    } else {
+        syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+    }
+}
+
+}  // namespace rocshmem
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright (c) 2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_THREAD_PLACEMENT_HPP
+#define ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_THREAD_PLACEMENT_HPP
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hip_allocator.hpp"
+
+/**
+ * @file thread_placement.hpp
+ *
+ * @brief Contains the CPU and NUMA placement of the RO host side
+ *
+ * The queue pollers and the MPI progress threads sit on the critical path
+ * of every device request. When the scheduler migrates them, or runs them
+ * on a socket away from the GPU, each request pays for cold caches and
+ * cross-socket traffic. The CPUs of each thread role are read from the
+ * environment:
+ *
+ *   RO_NET_POLLER_CPUS    queue pollers
+ *   RO_NET_PROGRESS_CPUS  MPI progress threads
+ *
+ * Each takes a CPU list (e.g. "0-3,8"), which pins the i-th thread of the
+ * role to the i-th CPU of the list (wrapping around), or "auto", which
+ * confines the threads to the CPUs local to the GPU and leaves the choice
+ * among them to the scheduler. Unset leaves the threads unpinned.
+ *
+ * The device queues the pollers read are placed on the GPU's NUMA node
+ * by HIPHostLocalAllocator.
+ */
+
+namespace rocshmem {
+
+/**
+ * @brief Parse a Linux style CPU list such as "0-3,8,10-11"
+ *
+ * @param[in] CPU list
+ *
+ * @return CPU ids in list order; empty if the list is malformed
+ */
+std::vector<int>
+parse_cpu_list(const std::string &list);
+
+/**
+ * @brief NUMA node the current HIP device is attached to
+ *
+ * @return Node id or -1 if the node is unknown
+ */
+int
+gpu_numa_node();
+
+/**
+ * @brief CPUs local to the current HIP device
+ *
+ * @return CPU ids; empty if they are unknown
+ */
+std::vector<int>
+gpu_local_cpus();
+
+struct ThreadPlacement {
+    /**
+     * @brief CPUs available to the threads of the role
+     */
+    std::vector<int> cpus {};
+
+    /**
+     * @brief Pin each thread to a single CPU of the list
+     *
+     * When false, every thread may run on any CPU of the list.
+     */
+    bool one_cpu_per_thread {false};
+
+    /**
+     * @brief Read the placement of a thread role from the environment
+     *
+     * @param[in] Name of the environment variable
+     *
+     * @return The placement; empty (no pinning) if unset or unusable
+     */
+    static ThreadPlacement
+    from_env(const char *name);
+
+    /**
+     * @brief Set the affinity of a running thread
+     *
+     * Placement is a performance hint, so a failure only warns.
+     *
+     * @param[in] Thread to place
+     * @param[in] Index of the thread within its role
+     */
+    void
+    apply(std::thread &thread, size_t index) const;
+};
+
+/**
+ * @brief Coherent host memory placed on the GPU's NUMA node
+ *
+ * hipHostMalloc otherwise takes pages from a fixed node, which may be a
+ * socket away from both the GPU writing the memory and the host thread
+ * polling it. The calling thread's memory policy prefers the GPU's node
+ * for the duration of the allocation, which hipHostMallocNumaUser makes
+ * the runtime honor when it populates the pages.
+ */
+class HIPHostLocalAllocator : public MemoryAllocator
+{
+  public:
+    HIPHostLocalAllocator()
+        : MemoryAllocator(hipHostMalloc,
+                          hipFree,
+                          hipHostMallocCoherent | hipHostMallocNumaUser)
+    {
+    }
+
+    /**
+     * @brief Allocates memory
+     *
+     * @param[in, out] Address of raw pointer (&pointer_to_char)
+     * @param[in] Size in bytes of memory allocation
+     */
+    void
+    allocate(void** ptr, size_t size);
+};
+
+}  // namespace rocshmem
+
+#endif  // ROCSHMEM_LIBRARY_SRC_REVERSE_OFFLOAD_THREAD_PLACEMENT_HPP
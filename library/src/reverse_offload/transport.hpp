@@ -150,7 +150,7 @@ class Transport {
     virtual Status
     putMem(void *dst,
            void *src,
-           int size,
+           size_t size,
            int pe,
            int wg_id,
            int threadId,
@@ -160,7 +160,7 @@ class Transport {
     virtual Status
     getMem(void *dst,
            void *src,
-           int size,
+           size_t size,
            int pe,
            int wg_id,
            int threadId,
@@ -217,8 +217,10 @@ class Transport {
     virtual void
     global_exit(int status) = 0;
 
-    virtual void
+    virtual bool
     insertRequest(const queue_element_t *element,
+                  const queue_element_ext_t *ext,
+                  const char *payload,
                   int queue_id) = 0;
 
   protected:
@@ -158,6 +158,13 @@ roc_shmem_malloc(size_t size)
     return ptr;
 }
 
+[[maybe_unused]]
+__host__ void *
+roc_shmem_malloc_with_hints(size_t size, [[maybe_unused]] long hints)
+{
+    return roc_shmem_malloc(size);
+}
+
 [[maybe_unused]]
 __host__ void
 roc_shmem_free(void *ptr)
@@ -169,6 +176,34 @@ roc_shmem_free(void *ptr)
     backend->heap.free(ptr);
 }
 
+[[maybe_unused]]
+__host__ void *
+roc_shmem_realloc(void *ptr, size_t size)
+{
+    VERIFY_BACKEND();
+
+    roc_shmem_barrier_all();
+
+    void *new_ptr {backend->heap.realloc(ptr, size)};
+
+    roc_shmem_barrier_all();
+
+    return new_ptr;
+}
+
+[[maybe_unused]]
+__host__ void *
+roc_shmem_align(size_t alignment, size_t size)
+{
+    VERIFY_BACKEND();
+
+    void *ptr {backend->heap.malign(alignment, size)};
+
+    roc_shmem_barrier_all();
+
+    return ptr;
+}
+
 [[maybe_unused]]
 __host__ Status
 roc_shmem_reset_stats()